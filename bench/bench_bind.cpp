@@ -0,0 +1,117 @@
+//* 类型绑定基准: 把一组记录读进结构体, 比较 parse() 建树后逐个字段取值与 json_bind 直接从 token 读取; 以及从结构体写回 JSON
+//* 用法: bench_bind [记录数]
+
+#include "../json_bind.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+namespace {
+
+struct position {
+    double x;
+    double y;
+};
+
+struct record {
+    int64_t                    id;
+    std::string                name;
+    std::string                email;
+    double                     score;
+    bool                       active;
+    std::vector<std::string>   tags;
+    position                   pos;
+    std::optional<std::string> note;
+};
+
+struct dataset {
+    std::vector<record> records;
+};
+
+}  // namespace
+
+JSON_BIND(position, x, y)
+JSON_BIND(record, id, name, email, score, active, tags, pos, note)
+JSON_BIND(dataset, records)
+
+namespace {
+
+std::string make_document(std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::string                      text = R"({"records":[)";
+    for (std::size_t i = 0; i < records; i++) {
+        if (i != 0) {
+            text.push_back(',');
+        }
+        text += fmt::format(R"({{"id":{},"name":"user_{}","email":"user{}@example.com","score":{},"active":{},)"
+                            R"("tags":["a","b\n\"c\""],"pos":{{"x":{},"y":{}}},"note":null}})",
+                            rng() >> 1, i, rng() % 100000, real(rng), rng() % 2 ? "true" : "false", real(rng), real(rng));
+    }
+    text += "]}";
+    return text;
+}
+
+//* 以前的写法: 先建树, 再一个字段一个字段地取出来
+dataset from_document(json_document& js)
+{
+    dataset out;
+    for (json_value* value : js["records"].get_array()) {
+        json_value& r = *value;
+        record      rec;
+        rec.id     = r["id"].get_int64();
+        rec.name   = r["name"].get_string();
+        rec.email  = r["email"].get_string();
+        rec.score  = r["score"].get_number();
+        rec.active = r["active"].get_boolean();
+        for (json_value* tag : r["tags"].get_array()) {
+            rec.tags.push_back(tag->get_string());
+        }
+        rec.pos.x = r["pos"]["x"].get_number();
+        rec.pos.y = r["pos"]["y"].get_number();
+        out.records.push_back(std::move(rec));
+    }
+    return out;
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 5;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::string text    = make_document(records);
+
+    std::size_t count  = 0;
+    auto        report = [&](const char* name, double seconds) {
+        fmt::print("{:<24} {:>10.1f} MB/s {:>10.2f} ms\n", name, text.size() / seconds / 1e6, seconds * 1e3);
+    };
+
+    fmt::print("input {:.1f} MB, {} records\n", text.size() / 1e6, records);
+    report("parse() then extract", measure([&] {
+               json_parser   parser(text.data(), text.size());
+               json_document js = parser.parse();
+               count += from_document(js).records.size();
+           }));
+    report("json_bind::parse", measure([&] { count += json_bind<dataset>::parse(text.data(), text.size()).records.size(); }));
+
+    dataset data = json_bind<dataset>::parse(text.data(), text.size());
+    report("json_bind::to_string", measure([&] { count += json_bind<dataset>::to_string(data).size(); }));
+    return count == 0;
+}
@@ -0,0 +1,75 @@
+//* 磁盘缓存基准: 同一个大文件, 比较每次 json_parser 解析、parse_tape() 和 json_tape_cache 命中缓存时的加载耗时
+//* 用法: bench_cache [记录数]
+
+#include "../json_cache.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+void make_file(const std::string& path, std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::ofstream                    out(path, std::ios::binary | std::ios::trunc);
+    out << R"({"version":3,"services":[)";
+    for (std::size_t i = 0; i < records; i++) {
+        out << (i != 0 ? "," : "")
+            << fmt::format(R"({{"id":{},"name":"service_{}","host":"10.0.{}.{}","weight":{},"enabled":{},"tags":["a","b"]}})", i, i, i / 256 % 256,
+                           i % 256, real(rng), rng() % 2 ? "true" : "false");
+    }
+    out << "]}";
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 5;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::string directory = (std::filesystem::temp_directory_path() / "bench_cache").string();
+    std::string path      = directory + "/config.json";
+    std::filesystem::create_directories(directory);
+    make_file(path, records);
+
+    json_tape_cache cache(directory);
+    cache.load(path);  // 写好缓存
+
+    std::size_t sink   = 0;
+    auto        report = [&](const char* name, double seconds) { fmt::print("{:<24} {:>10.3f} ms\n", name, seconds * 1e3); };
+
+    fmt::print("input {:.1f} MB, {} records\n", std::filesystem::file_size(path) / 1e6, records);
+    report("parse()", measure([&] {
+               json_parser   parser(path);
+               json_document js = parser.parse();
+               sink += js["version"].get_int64();
+           }));
+    report("parse_tape()", measure([&] {
+               json_parser parser(path);
+               json_tape   tape = parser.parse_tape();
+               sink += tape["version"].get_int64();
+           }));
+    report("cached load", measure([&] {
+               json_cached_tape tape = cache.load(path);
+               sink += tape["version"].get_int64() + tape.from_cache();
+           }));
+    std::filesystem::remove_all(directory);
+    return sink == 0;
+}
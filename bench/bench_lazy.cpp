@@ -0,0 +1,71 @@
+//* 按需访问基准: 在大文档里读几个字段, 比较 json_parser::parse() 建树后访问与 json_lazy_document 直接访问
+//* 用法: bench_lazy [记录数]
+
+#include "../json_lazy.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+//* {"id":..., "records":[...], "arguments":{"game":[...]}}: 要读的字段在大数组之后, 按需访问必须跳过整个数组
+std::string make_document(std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::string                      text = R"({"id":42,"records":[)";
+    for (std::size_t i = 0; i < records; i++) {
+        if (i != 0) {
+            text.push_back(',');
+        }
+        text += fmt::format(R"({{"id":{},"name":"user_{}","email":"user{}@example.com","score":{},"ratio":{},)"
+                            R"("active":{},"tags":["a","b\n\"c\""],"pos":{{"x":{},"y":{}}},"note":null}})",
+                            rng() >> 1, i, rng() % 100000, real(rng), real(rng) / 7, rng() % 2 ? "true" : "false", real(rng), real(rng));
+    }
+    text += R"(],"arguments":{"game":["chess",1.5,true]}})";
+    return text;
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 5;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::string text    = make_document(records);
+
+    double sum    = 0;
+    auto   report = [&](const char* name, double seconds) {
+        fmt::print("{:<24} {:>10.1f} MB/s {:>10.2f} ms\n", name, text.size() / seconds / 1e6, seconds * 1e3);
+    };
+
+    fmt::print("input {:.1f} MB, {} records\n", text.size() / 1e6, records);
+    report("parse() then access", measure([&] {
+               json_parser   parser(text.data(), text.size());
+               json_document js = parser.parse();
+               sum += js["id"].get_number() + js["arguments"]["game"][1].get_number();
+           }));
+    report("lazy access", measure([&] {
+               json_lazy_document js(text.data(), text.size());
+               sum += js["id"].get_number() + js["arguments"]["game"][1].get_number();
+           }));
+    report("lazy one record", measure([&] {
+               json_lazy_document js(text.data(), text.size());
+               sum += js["records"][records / 2]["score"].get_number();
+           }));
+    return sum == 0;
+}
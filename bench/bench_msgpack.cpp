@@ -0,0 +1,79 @@
+//* MessagePack 基准: 与文本 JSON 比较编码后的大小、to_string() 与 json_msgpack_writer 的编码速度、parse() 与 json_msgpack_parser 的解码速度
+//* 用法: bench_msgpack [记录数]
+
+#include "../json_msgpack.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+std::string make_document(std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::string                      text = "[";
+    for (std::size_t i = 0; i < records; i++) {
+        if (i != 0) {
+            text.push_back(',');
+        }
+        text += fmt::format(R"({{"id":{},"name":"user_{}","email":"user{}@example.com","score":{},"level":{},)"
+                            R"("active":{},"tags":["a","b\n\"c\""],"pos":{{"x":{},"y":{}}},"note":null}})",
+                            rng() >> 1, i, rng() % 100000, real(rng), rng() % 100, rng() % 2 ? "true" : "false", real(rng), real(rng));
+    }
+    text += "]";
+    return text;
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 5;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::string text    = make_document(records);
+
+    json_parser   parser(text.data(), text.size());
+    json_document doc = parser.parse();
+    std::string   binary;
+    json_msgpack_writer(binary).write(doc.root());
+
+    std::size_t sink   = 0;
+    auto        report = [&](const char* name, std::size_t bytes, double seconds) {
+        fmt::print("{:<24} {:>10.1f} MB/s {:>10.2f} ms\n", name, bytes / seconds / 1e6, seconds * 1e3);
+    };
+
+    fmt::print("{} records: json {:.1f} MB, msgpack {:.1f} MB ({:.0f}%)\n", records, text.size() / 1e6, binary.size() / 1e6,
+               100.0 * binary.size() / text.size());
+    report("to_string()", text.size(), measure([&] { sink += doc.to_string().size(); }));
+    report("msgpack write", binary.size(), measure([&] {
+               std::string out;
+               json_msgpack_writer(out).write(doc.root());
+               sink += out.size();
+           }));
+    report("parse()", text.size(), measure([&] {
+               json_parser   p(text.data(), text.size());
+               json_document js = p.parse();
+               sink += js[0]["id"].get_int64() & 1;
+           }));
+    report("msgpack parse", binary.size(), measure([&] {
+               json_msgpack_parser p(binary.data(), binary.size());
+               json_document       js = p.parse();
+               sink += js[0]["id"].get_int64() & 1;
+           }));
+    return sink == 0;
+}
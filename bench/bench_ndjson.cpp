@@ -0,0 +1,70 @@
+//* NDJSON 并行解析基准: 同一份输入分别用 1, 2, 4 ... 个线程解析, 输出吞吐量和相对单线程的加速比
+//* 用法: bench_ndjson [记录数] [最多线程数]
+
+#include "../json_ndjson.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace json;
+
+namespace {
+
+//* 每行一条记录, 混合字符串、整数、浮点、布尔和嵌套容器
+std::string make_lines(std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::string                      text;
+    for (std::size_t i = 0; i < records; i++) {
+        text += fmt::format(R"({{"id":{},"name":"user_{}","email":"user{}@example.com","score":{},"ratio":{},)"
+                            R"("active":{},"tags":["a","b\n\"c\""],"pos":{{"x":{},"y":{}}},"note":null}})"
+                            "\n",
+                            rng() >> 1, i, rng() % 100000, real(rng), real(rng) / 7, rng() % 2 ? "true" : "false", real(rng), real(rng));
+    }
+    return text;
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 3;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    unsigned    max     = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    std::string text    = make_lines(records);
+
+    fmt::print("input {:.1f} MB, {} records, {} hardware threads\n", text.size() / 1e6, records, std::thread::hardware_concurrency());
+    double base = 0;
+    for (unsigned threads = 1; threads <= max; threads *= 2) {
+        std::size_t ok      = 0;
+        double      seconds = measure([&] {
+            //* 回调方式: 只统计成功的行, 不保留结果. 计时包括线程池的创建
+            json_ndjson_parser parser(text.data(), text.size(), threads);
+            ok = 0;
+            parser.parse([&](json_ndjson_record& record) {
+                ok += record.ok();
+                return true;
+            });
+        });
+        if (base == 0) {
+            base = seconds;
+        }
+        fmt::print("{:>3} threads {:>10.1f} MB/s {:>10.2f} ms {:>6.2f}x  ({} ok)\n", threads, text.size() / seconds / 1e6, seconds * 1e3,
+                   base / seconds, ok);
+    }
+    return 0;
+}
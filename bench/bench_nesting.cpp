@@ -0,0 +1,73 @@
+//* 深层嵌套基准: 数组和对象各嵌套 depth 层, 最里面是一个小记录; 每层的解析耗时应当与深度无关, 总耗时随深度线性增长
+//* 最后按默认的深度上限解析最深的文档, 看它在多深、多快的时候被拒绝
+//* 用法: bench_nesting [最大深度]
+
+#include "../json_parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+//* [[...[{"id":1,"name":"leaf"}]...]] 或 {"a":{"a":...{"id":1,"name":"leaf"}...}}, 每层再带一个兄弟元素
+std::string make_document(std::size_t depth, bool object)
+{
+    std::string text;
+    for (std::size_t i = 0; i < depth; i++) {
+        text += object ? R"({"n":1,"a":)" : "[1,";
+    }
+    text += R"({"id":1,"name":"leaf"})";
+    for (std::size_t i = 0; i < depth; i++) {
+        text += object ? '}' : ']';
+    }
+    return text;
+}
+
+double measure(const std::string& text, std::size_t depth, bool object)
+{
+    constexpr int rounds = 5;
+    std::size_t   sink   = 0;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        json_parser parser(text.data(), text.size());
+        parser.set_max_depth(depth + 1);  // 最里面的记录也算一层
+        json_document doc   = parser.parse();
+        json_value*   value = &doc.root();
+        for (std::size_t d = 0; d < depth; d++) {
+            value = object ? &(*value)["a"] : &(*value)[1];
+        }
+        sink += (*value)["name"].get_string_view().size();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+    return sink == 0 ? 0 : seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t max_depth = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+
+    fmt::print("{:>10} {:>14} {:>14} {:>14} {:>14}\n", "depth", "array ms", "array ns/lvl", "object ms", "object ns/lvl");
+    for (std::size_t depth = 1024; depth <= max_depth; depth *= 4) {
+        double array  = measure(make_document(depth, false), depth, false);
+        double object = measure(make_document(depth, true), depth, true);
+        fmt::print("{:>10} {:>14.2f} {:>14.1f} {:>14.2f} {:>14.1f}\n", depth, array * 1e3, array * 1e9 / depth, object * 1e3, object * 1e9 / depth);
+    }
+
+    std::string text  = make_document(max_depth, true);
+    auto        start = std::chrono::steady_clock::now();
+    try {
+        json_parser parser(text.data(), text.size());
+        parser.parse();
+        fmt::print("default limit: depth {} accepted\n", max_depth);
+    } catch (const json_parse_error& e) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fmt::print("default limit: {} after {:.2f} ms\n", e.what(), seconds * 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+//* 数字解析基准: parse_number 与 std::stod/std::strtod 对比
+//* 用法: bench_number [数字个数]
+
+#include "../json_number.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+namespace {
+
+struct corpus {
+    std::string              text;     // 所有数字以空格分隔
+    std::vector<std::size_t> offsets;  // 每个数字的起始位置
+};
+
+//* 三类输入: 小整数、随机 double 的最短表示、较长的定点小数
+corpus make_corpus(const char* kind, std::size_t count)
+{
+    corpus                          c;
+    std::mt19937_64                 rng(2024);
+    std::uniform_real_distribution<> real(-1e6, 1e6);
+    for (std::size_t i = 0; i < count; i++) {
+        c.offsets.push_back(c.text.size());
+        if (std::strcmp(kind, "integer") == 0) {
+            c.text += fmt::format("{}", static_cast<int64_t>(rng() % 10000000) - 5000000);
+        } else if (std::strcmp(kind, "double") == 0) {
+            uint64_t bits = (rng() & 0x800FFFFFFFFFFFFF) | ((uint64_t(rng() % 200) + 923) << 52);
+            double   d;
+            std::memcpy(&d, &bits, sizeof(d));
+            c.text += fmt::format("{}", d);
+        } else {
+            c.text += fmt::format("{:.6f}", real(rng));
+        }
+        c.text.push_back(' ');
+    }
+    return c;
+}
+
+template <class F> double measure(const corpus& c, F&& parse_one)
+{
+    double sink  = 0;
+    auto   start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 5; round++) {
+        for (std::size_t off : c.offsets) {
+            sink += parse_one(c.text.data() + off);
+        }
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 5;
+    if (sink == 42.0) {
+        fmt::print("");
+    }
+    return seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    fmt::print("{:<10} {:<14} {:>10} {:>12}\n", "corpus", "parser", "MB/s", "ns/number");
+    for (const char* kind : {"integer", "double", "fixed"}) {
+        corpus      c   = make_corpus(kind, count);
+        const char* end = c.text.data() + c.text.size();
+
+        //* 先确认结果一致再计时
+        for (std::size_t off : c.offsets) {
+            json_number n;
+            parse_number(c.text.data() + off, end, n);
+            if (n.as_double() != std::strtod(c.text.data() + off, nullptr)) {
+                fmt::print("mismatch at {}\n", c.text.substr(off, 32));
+                return 1;
+            }
+        }
+
+        auto report = [&](const char* name, double seconds) {
+            fmt::print("{:<10} {:<14} {:>10.1f} {:>12.1f}\n", kind, name, c.text.size() / seconds / 1e6, seconds * 1e9 / count);
+        };
+        report("parse_number", measure(c, [&](const char* p) {
+                   json_number n;
+                   parse_number(p, end, n);
+                   return n.as_double();
+               }));
+        //* 旧实现的做法: 先把数字拷进 std::string 再调用 std::stod
+        report("std::stod", measure(c, [&](const char* p) {
+                   std::string s(p, std::strchr(p, ' '));
+                   return std::stod(s);
+               }));
+        report("std::strtod", measure(c, [&](const char* p) { return std::strtod(p, nullptr); }));
+    }
+    return 0;
+}
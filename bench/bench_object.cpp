@@ -0,0 +1,105 @@
+//* 对象存储基准: 扁平有序的 json_object 与之前用的 std::pmr::unordered_map 比较查找耗时和占用的 arena 字节数,
+//* 以及键驻留以后用 json_key 查找的耗时
+//* 用法: bench_object [每种大小的对象数]
+
+#include "../json_intern.hpp"
+#include "../json_parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace json;
+
+namespace {
+
+using hash_object = std::pmr::unordered_map<json_string, json_value*>;
+
+template <class F> double measure(std::size_t ops, F&& run)
+{
+    auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t     count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    std::mt19937_64 rng(7);
+
+    fmt::print("{:>6} {:>14} {:>14} {:>14} {:>16} {:>16}\n", "keys", "flat ns", "interned ns", "map ns", "flat bytes/obj", "map bytes/obj");
+    for (std::size_t size : {2, 4, 8, 16, 64, 1024}) {
+        std::size_t              objects = std::max<std::size_t>(1, count * 16 / size);
+        std::vector<std::string> keys;
+        for (std::size_t i = 0; i < size; i++) {
+            keys.push_back(fmt::format("field_{}", i));
+        }
+        json_value* dummy = reinterpret_cast<json_value*>(&keys);
+
+        json_arena                flat_arena;
+        std::vector<json_object*> flat;
+        for (std::size_t o = 0; o < objects; o++) {
+            json_object* object = flat_arena.create<json_object>(&flat_arena);
+            for (const std::string& k : keys) {
+                object->insert(k, dummy);
+            }
+            flat.push_back(object);
+        }
+        json_key_table            table;
+        std::vector<json_key>     interned;
+        for (const std::string& k : keys) {
+            interned.push_back(table.intern(k));
+        }
+        json_arena                key_arena;
+        std::vector<json_object*> keyed;
+        for (std::size_t o = 0; o < objects; o++) {
+            json_object* object = key_arena.create<json_object>(&key_arena);
+            for (json_key k : interned) {
+                object->insert(k, dummy);
+            }
+            keyed.push_back(object);
+        }
+        json_arena                map_arena;
+        std::vector<hash_object*> maps;
+        for (std::size_t o = 0; o < objects; o++) {
+            hash_object* object = map_arena.create<hash_object>(&map_arena);
+            for (const std::string& k : keys) {
+                object->insert_or_assign(json_string(k, &map_arena), dummy);
+            }
+            maps.push_back(object);
+        }
+
+        //* 随机的对象和键, 查找的键是普通的 std::string, 和 operator[] 的用法一样
+        constexpr std::size_t    lookups = 1000000;
+        std::vector<std::size_t> picks(lookups);
+        for (std::size_t& p : picks) {
+            p = rng();
+        }
+        std::size_t found   = 0;
+        double      flat_ns = measure(lookups, [&] {
+            for (std::size_t p : picks) {
+                found += flat[p % objects]->find(keys[(p >> 32) % size]) != nullptr;
+            }
+        });
+        double      key_ns  = measure(lookups, [&] {
+            for (std::size_t p : picks) {
+                found += keyed[p % objects]->find(interned[(p >> 32) % size]) != nullptr;
+            }
+        });
+        double      map_ns  = measure(lookups, [&] {
+            for (std::size_t p : picks) {
+                hash_object& m = *maps[p % objects];
+                found += m.find(json_string(keys[(p >> 32) % size])) != m.end();
+            }
+        });
+        fmt::print("{:>6} {:>14.1f} {:>14.1f} {:>14.1f} {:>16.0f} {:>16.0f}{}\n", size, flat_ns * 1e9, key_ns * 1e9, map_ns * 1e9,
+                   double(flat_arena.bytes_used()) / objects, double(map_arena.bytes_used()) / objects, found == 3 * lookups ? "" : " (missing keys!)");
+    }
+    return 0;
+}
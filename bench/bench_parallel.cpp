@@ -0,0 +1,68 @@
+//* 单个大文档的并行解析基准: 对象数组分别用 1, 2, 4 ... 个线程解析, 输出吞吐量和相对 json_parser::parse() 的加速比
+//* 用法: bench_parallel [记录数] [最多线程数]
+
+#include "../json_parallel.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace json;
+
+namespace {
+
+//* 一个对象数组, 每条记录混合字符串、整数、浮点、布尔和嵌套容器
+std::string make_document(std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::string                      text = "[";
+    for (std::size_t i = 0; i < records; i++) {
+        if (i != 0) {
+            text.push_back(',');
+        }
+        text += fmt::format(R"({{"id":{},"name":"user_{}","email":"user{}@example.com","score":{},"ratio":{},)"
+                            R"("active":{},"tags":["a","b\n\"c\""],"pos":{{"x":{},"y":{}}},"note":null}})",
+                            rng() >> 1, i, rng() % 100000, real(rng), real(rng) / 7, rng() % 2 ? "true" : "false", real(rng), real(rng));
+    }
+    text.push_back(']');
+    return text;
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 3;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    unsigned    max     = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    std::string text    = make_document(records);
+
+    fmt::print("input {:.1f} MB, {} records, {} hardware threads\n", text.size() / 1e6, records, std::thread::hardware_concurrency());
+    double base = measure([&] {
+        json_parser   parser(text.data(), text.size());
+        json_document doc = parser.parse();
+    });
+    fmt::print("{:<11} {:>10.1f} MB/s {:>10.2f} ms\n", "json_parser", text.size() / base / 1e6, base * 1e3);
+    for (unsigned threads = 2; threads <= max; threads *= 2) {
+        double seconds = measure([&] {
+            //* 计时包括线程池的创建
+            json_parallel_parser parser(text.data(), text.size(), threads);
+            json_document        doc = parser.parse();
+        });
+        fmt::print("{:>3} threads {:>10.1f} MB/s {:>10.2f} ms {:>6.2f}x\n", threads, text.size() / seconds / 1e6, seconds * 1e3, base / seconds);
+    }
+    return 0;
+}
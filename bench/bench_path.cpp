@@ -0,0 +1,74 @@
+//* 路径查询基准: 在 DOM 上比较链式 operator[] 与编译好的 json_path,
+//* 以及"解析整棵树再查"与 json_extractor 一趟提取多条路径
+//* 用法: bench_path [次数]
+
+#include "../json_path.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+//* 路由场景的请求: 要读的字段分散在头部和尾部, 中间夹着一段不关心的负载
+std::string make_request()
+{
+    std::string text = R"({"id":42,"method":"play","meta":{"user":{"name":"alice","region":"eu-west"},"trace":"abc"},"payload":[)";
+    for (int i = 0; i < 200; i++) {
+        text += fmt::format(R"({}{{"k":{},"v":"value_{}"}})", i == 0 ? "" : ",", i, i);
+    }
+    text += R"(],"arguments":{"game":["chess",1.5,true],"level":3}})";
+    return text;
+}
+
+template <class F> double measure(std::size_t rounds, F&& run)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    std::string text   = make_request();
+
+    json_parser   parser(text.data(), text.size());
+    json_document doc = parser.parse();
+    json_path     user  = json_path::pointer("/meta/user/region");
+    json_path     game  = json_path::parse("$.arguments.game[1]");
+    json_path     level = json_path::parse("$.arguments.level");
+
+    double sum    = 0;
+    auto   report = [&](const char* name, double seconds) { fmt::print("{:<28} {:>10.1f} ns\n", name, seconds * 1e9); };
+
+    fmt::print("request {} bytes, {} rounds\n", text.size(), rounds);
+    report("dom chained operator[]", measure(rounds * 10, [&] {
+               sum += doc["meta"]["user"]["region"].get_string().size() + doc["arguments"]["game"][1].get_number() +
+                      doc["arguments"]["level"].get_number();
+           }));
+    report("dom compiled path", measure(rounds * 10, [&] {
+               sum += user.find(doc)->get_string().size() + game.find(doc)->get_number() + level.find(doc)->get_number();
+           }));
+    report("parse then compiled path", measure(rounds, [&] {
+               json_parser   p(text.data(), text.size());
+               json_document d = p.parse();
+               sum += user.find(d)->get_string().size() + game.find(d)->get_number() + level.find(d)->get_number();
+           }));
+    json_extractor extractor;
+    std::size_t    ids[] = {extractor.add(user), extractor.add(game), extractor.add(level)};
+    report("extractor single pass", measure(rounds, [&] {
+               extractor.clear();
+               json_parser p(text.data(), text.size());
+               p.parse(extractor);
+               sum += extractor.find(ids[0])->get_string().size() + extractor.find(ids[1])->get_number() + extractor.find(ids[2])->get_number();
+           }));
+    return sum == 0;
+}
@@ -0,0 +1,135 @@
+//* 编译期配置基准: 同一份输入分别用 json_parser、默认配置的 json_basic_parser 和 json_minimal_policy 解析,
+//* SAX 方式(不建树)和建树各比一次
+//* 用法: bench_policy [MB]
+
+#include "../json_basic_parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+//* 类似 API 返回的记录数组: 字符串、整数、小数、布尔和嵌套对象都有, 少量字符串带转义
+std::string make_document(std::size_t bytes)
+{
+    std::mt19937_64 rng(7);
+    std::string     text = "[";
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        text += fmt::format(R"({}{{"id":{},"user":{{"name":"user_{}","followers":{},"verified":{}}},"text":"{}",)"
+                            R"("score":{},"tags":["a","bc","def"],"reply":null}})",
+                            i ? "," : "", rng() >> 1, i, rng() % 100000, rng() % 2 ? "true" : "false",
+                            i % 8 ? "plain text of a message" : "line\\nbreak \\\"quoted\\\"", (rng() % 100000) / 100.0);
+    }
+    return text + "]";
+}
+
+//* 不走虚函数的计数 handler
+struct counter {
+    std::size_t count = 0;
+
+    bool on_begin_object()
+    {
+        return true;
+    }
+    bool on_key(std::string_view k)
+    {
+        count += k.size();
+        return true;
+    }
+    bool on_end_object()
+    {
+        return true;
+    }
+    bool on_begin_array()
+    {
+        return true;
+    }
+    bool on_end_array()
+    {
+        return true;
+    }
+    bool on_string(std::string_view s)
+    {
+        count += s.size();
+        return true;
+    }
+    bool on_number(const json_number& n)
+    {
+        count += n.type;
+        return true;
+    }
+    bool on_boolean(bool b)
+    {
+        count += b;
+        return true;
+    }
+    bool on_null()
+    {
+        count++;
+        return true;
+    }
+};
+
+template <class F> void report(const char* name, const std::string& text, F&& run)
+{
+    constexpr int rounds = 5;
+    run();  // 预热, 让 arena 和缓冲区长到稳定的大小
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+    fmt::print("{:<28} {:>10.1f} MB/s {:>10.2f} ms\n", name, text.size() / seconds / 1e6, seconds * 1e3);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t mb   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 64;
+    std::string text = make_document(mb << 20);
+    std::size_t sink = 0;
+
+    json_parser                            general;
+    json_basic_parser<>                    basic(text.data(), text.size());
+    json_basic_parser<json_minimal_policy> minimal(text.data(), text.size());
+    json_document                          doc;
+
+    report("sax json_parser", text, [&] {
+        counter c;
+        general.reset(text.data(), text.size());
+        general.parse(c);
+        sink += c.count;
+    });
+    report("sax basic<json_policy>", text, [&] {
+        counter c;
+        basic.reset(text.data(), text.size());
+        basic.parse(c);
+        sink += c.count;
+    });
+    report("sax basic<minimal_policy>", text, [&] {
+        counter c;
+        minimal.reset(text.data(), text.size());
+        sink += minimal.parse(c).ok() ? c.count : 0;
+    });
+    report("tree json_parser", text, [&] {
+        general.reset(text.data(), text.size());
+        general.parse(doc);
+        sink += doc[0]["id"].is_integer();
+    });
+    report("tree basic<json_policy>", text, [&] {
+        basic.reset(text.data(), text.size());
+        basic.parse(doc);
+        sink += doc[0]["id"].is_integer();
+    });
+    report("tree basic<minimal_policy>", text, [&] {
+        minimal.reset(text.data(), text.size());
+        sink += minimal.parse(doc).ok();
+    });
+    return sink == 0;
+}
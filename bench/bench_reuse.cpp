@@ -0,0 +1,92 @@
+//* 小消息基准: 每条消息新建解析器和文档, 与复用同一个解析器和文档(reset + parse(json_document&))比较吞吐和每条消息的堆分配次数
+//* 用法: bench_reuse [消息数]
+
+#include "../json_parser.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+std::vector<std::string> make_messages(std::size_t count)
+{
+    std::mt19937_64          rng(7);
+    std::vector<std::string> messages;
+    for (std::size_t i = 0; i < count; i++) {
+        messages.push_back(fmt::format(R"({{"jsonrpc":"2.0","id":{},"method":"user.update","params":{{"id":{},"name":"user_{}",)"
+                                       R"("email":"user{}@example.com","score":{},"tags":["a","b"],"active":{}}}}})",
+                                       i, rng() >> 1, i, rng() % 100000, (rng() % 100000) / 100.0, rng() % 2 ? "true" : "false"));
+    }
+    return messages;
+}
+
+template <class F> void report(const char* name, std::size_t count, F&& run)
+{
+    std::size_t before = allocations.load();
+    auto        start  = std::chrono::steady_clock::now();
+    run();
+    double      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::size_t after   = allocations.load();
+    fmt::print("{:<24} {:>12.0f} msg/s {:>10.2f} allocs/msg\n", name, count / seconds, double(after - before) / count);
+}
+
+}  // namespace
+
+//* 统计整个程序的堆分配次数
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t              count    = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    std::vector<std::string> messages = make_messages(count);
+    int64_t                  sum      = 0;
+
+    report("new parser per message", count, [&] {
+        for (const std::string& m : messages) {
+            json_parser   parser(m.data(), m.size());
+            json_document doc = parser.parse();
+            sum += doc["id"].get_int64();
+        }
+    });
+
+    json_parser   parser;
+    json_document doc;
+    //* 先让缓冲区和 arena 长到稳定的大小
+    for (std::size_t i = 0; i < std::min<std::size_t>(count, 16); i++) {
+        parser.reset(messages[i].data(), messages[i].size());
+        parser.parse(doc);
+    }
+    report("reused parser", count, [&] {
+        for (const std::string& m : messages) {
+            parser.reset(m.data(), m.size());
+            parser.parse(doc);
+            sum += doc["id"].get_int64();
+        }
+    });
+    return sum == 0;
+}
@@ -0,0 +1,104 @@
+//* 解析统计: 对每个文档打印 json_parser::stats() 和按窗口的跟踪结果, 看慢的文档慢在哪个阶段.
+//* 需要 make STATS=1 bench 编译; 不打开时统计全为 0, 只剩吞吐, 两次的吞吐之差就是统计本身的开销
+//* 用法: bench_stats [文件...], 不给文件时用生成的三类文档
+
+#include "../json_parser.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace json;
+
+namespace {
+
+std::string make_numbers(std::size_t count, std::mt19937_64& rng)
+{
+    std::string s = "[";
+    for (std::size_t i = 0; i < count; i++) {
+        s += fmt::format("{}[{},{},{}]", i ? "," : "", (rng() % 2000000) / 1e4, int64_t(rng() % 100000) - 50000, rng() >> 1);
+    }
+    return s + "]";
+}
+
+std::string make_strings(std::size_t count, std::mt19937_64& rng)
+{
+    std::string s = "[";
+    for (std::size_t i = 0; i < count; i++) {
+        s += fmt::format(R"({}{{"id":{},"text":"line {}\n\"quoted\" é {}","plain":"user_{}"}})", i ? "," : "", i, rng() % 1000, rng(), i);
+    }
+    return s + "]";
+}
+
+std::string make_deep(std::size_t depth)
+{
+    std::string s;
+    for (std::size_t i = 0; i < depth; i++) {
+        s += i % 2 ? "[" : R"({"a":)";
+    }
+    s += "null";
+    for (std::size_t i = depth; i-- > 0;) {
+        s += i % 2 ? "]" : "}";
+    }
+    return s;
+}
+
+void report(const std::string& name, const std::string& text)
+{
+    json_parser parser(text.data(), text.size());
+    uint64_t    windows = 0;
+    uint64_t    slowest = 0;  // 最慢的一个窗口, 纳秒
+    parser.set_trace_hook([&](const json_trace_event& event) {
+        if (event.type == TRACE_WINDOW) {
+            windows++;
+            slowest = std::max(slowest, event.ns);
+        }
+    });
+    auto          start   = std::chrono::steady_clock::now();
+    json_document doc     = parser.parse();
+    double        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const json_parse_stats& stats = parser.stats();
+    fmt::print("{}\n", name);
+    fmt::print("  {:.1f} MB/s, {} bytes\n", text.size() / seconds / 1e6, stats.input_bytes);
+    fmt::print("  tokens: '{{' {}, '}}' {}, '[' {}, ']' {}, ':' {}, ',' {}\n", stats.count(BEGIN_OBJECT), stats.count(END_OBJECT), stats.count(BEGIN_ARRAY),
+               stats.count(END_ARRAY), stats.count(SEP_COLON), stats.count(SEP_COMMA));
+    fmt::print("  values: {} keys, {} strings ({} escaped, {} bytes), {} numbers, {} booleans, {} nulls\n", stats.keys, stats.strings(),
+               stats.escaped_strings, stats.string_bytes, stats.numbers(), stats.count(BOOLEAN), stats.count(NULL_VALUE));
+    fmt::print("  stage 1: {} windows ({} traced), {} structurals, {:.2f} ms, slowest window {:.3f} ms\n", stats.windows, windows,
+               stats.structurals, stats.stage1_ns / 1e6, slowest / 1e6);
+    fmt::print("  stage 2: {:.2f} ms, max depth {}\n", (stats.total_ns - stats.stage1_ns) / 1e6, stats.max_depth);
+    fmt::print("  arena: {} bytes used, {} bytes reserved\n", stats.arena_used, stats.arena_reserved);
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if (!JSON_PARSER_STATS) {
+        fmt::print("built without JSON_PARSER_STATS, only throughput is meaningful (make clean && make STATS=1 bench)\n");
+    }
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            std::ifstream in(argv[i], std::ios::binary);
+            report(argv[i], std::string(std::istreambuf_iterator<char>(in), {}));
+        }
+        return 0;
+    }
+    std::mt19937_64                                  rng(7);
+    std::vector<std::pair<std::string, std::string>> documents;
+    documents.emplace_back("numbers", make_numbers(400000, rng));
+    documents.emplace_back("strings", make_strings(200000, rng));
+    documents.emplace_back("deep", make_deep(1000000));
+    for (const auto& [name, text] : documents) {
+        report(name, text);
+    }
+    return 0;
+}
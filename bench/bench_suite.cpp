@@ -0,0 +1,371 @@
+//* 基准套件: 对一组标准语料分别测量 parse()、遍历访问和 to_string() 的吞吐、每个文档的堆分配次数和峰值 RSS.
+//* 语料由生成器合成, 模仿常用的 twitter / citm_catalog / canada 测试文件, 另外有深层嵌套、长字符串和宽对象;
+//* 也可以用 --corpus 加入真实文件. --json 时输出 JSON, 方便保存下来在版本之间比较.
+//* 用法: bench_suite [--json] [--scale MB] [--corpus file.json ...]
+
+#include "../json_parser.hpp"
+#include "../json_simd.hpp"
+#include "../json_writer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __GLIBC__
+#    include <malloc.h>
+#endif
+
+using namespace json;
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+double                   checksum = 0;  // 让编译器不能把被测的代码优化掉
+
+//* ---------- 语料生成 ----------
+
+//* 推文: 中等深度的对象, 大量短字符串(含转义和非 ASCII), 大整数 id, 大量 null/bool
+std::string make_twitter(std::size_t bytes, std::mt19937_64& rng)
+{
+    static const char* words[] = {"json", "parser", "fast", "数据", "解析", "café", "naïve", "日本語", "emoji 😀", "tab\\there", "quote \\\"x\\\""};
+    std::string        text    = R"({"statuses":[)";
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        std::string body;
+        for (int w = 0; w < 12; w++) {
+            body += words[rng() % std::size(words)];
+            body += ' ';
+        }
+        text += fmt::format(R"({}{{"id":{},"id_str":"{}","text":"{}","truncated":false,"in_reply_to_status_id":null,)"
+                            R"("user":{{"id":{},"name":"user {}","screen_name":"u{}","followers_count":{},"verified":{},)"
+                            R"("description":"{}","profile_image_url":"https://example.com/img/{}.png"}},)"
+                            R"("entities":{{"hashtags":[{{"text":"tag{}","indices":[{},{}]}}],"urls":[],"user_mentions":[]}},)"
+                            R"("retweet_count":{},"favorited":false,"coordinates":null,"lang":"ja"}})",
+                            i == 0 ? "" : ",", rng() | (1ULL << 60), rng() >> 4, body, rng() >> 20, i, i, rng() % 100000, rng() % 2 ? "true" : "false",
+                            body, i, rng() % 100, rng() % 140, rng() % 140, rng() % 1000);
+    }
+    return text + "]}";
+}
+
+//* 演出目录: 以数字字符串为键的宽对象, 大量小整数数组, 字符串很少
+std::string make_citm(std::size_t bytes, std::mt19937_64& rng)
+{
+    std::string text = R"({"events":{)";
+    for (std::size_t i = 0; text.size() < bytes / 2; i++) {
+        std::string topics;
+        for (int t = 0, n = int(rng() % 8) + 1; t < n; t++) {
+            topics += fmt::format("{}{}", t == 0 ? "" : ",", 337184000 + rng() % 1000);
+        }
+        text += fmt::format(R"({}"{}":{{"description":null,"id":{},"logo":null,"name":"Event {}","subTopicIds":[{}],"subjectCode":null,"topicIds":[{}]}})",
+                            i == 0 ? "" : ",", 138586341 + i, 138586341 + i, i, topics, topics);
+    }
+    text += R"(},"performances":[)";
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        std::string prices, areas;
+        for (int p = 0; p < 4; p++) {
+            prices += fmt::format(R"({}{{"amount":{},"audienceSubCategoryId":337100890,"seatCategoryId":{}}})", p == 0 ? "" : ",", (rng() % 300) * 100,
+                                  338937295 + p);
+            areas += fmt::format(R"({}{{"areaId":{},"blockIds":[]}})", p == 0 ? "" : ",", 205705993 + rng() % 100);
+        }
+        text += fmt::format(R"({}{{"eventId":{},"id":{},"logo":null,"name":null,"prices":[{}],"seatCategories":[{{"areas":[{}],"seatCategoryId":338937295}}],)"
+                            R"("start":{},"venueCode":"PLEYEL_PLEYEL"}})",
+                            i == 0 ? "" : ",", 138586341 + i, 339187000 + i, prices, areas, 1372701600000ULL + rng() % 100000000);
+    }
+    return text + "]}";
+}
+
+//* 地理坐标: 几乎全是长尾数的 double, 嵌套的二元数组
+std::string make_canada(std::size_t bytes, std::mt19937_64& rng)
+{
+    std::uniform_real_distribution<> lon(-141.0, -52.0), lat(41.0, 83.0);
+    std::string                      text = R"({"type":"FeatureCollection","features":[)";
+    for (std::size_t f = 0; text.size() < bytes; f++) {
+        text += fmt::format(R"({}{{"type":"Feature","properties":{{"name":"Canada"}},"geometry":{{"type":"Polygon","coordinates":[[)", f == 0 ? "" : ",");
+        for (int p = 0; p < 2000; p++) {
+            text += fmt::format("{}[{:.15g},{:.15g}]", p == 0 ? "" : ",", lon(rng), lat(rng));
+        }
+        text += "]]}}";
+    }
+    return text + "]}";
+}
+
+//* 深层嵌套: 许多个数组和对象交替嵌套 1000 层的子树
+std::string make_deep(std::size_t bytes, std::mt19937_64& rng)
+{
+    std::string text = "[";
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        text += i == 0 ? "" : ",";
+        for (int d = 0; d < 1000; d++) {
+            text += d % 2 ? R"({"k":)" : "[";
+        }
+        text += std::to_string(rng() % 1000);
+        for (int d = 999; d >= 0; d--) {
+            text += d % 2 ? '}' : ']';
+        }
+    }
+    return text + "]";
+}
+
+//* 长字符串: 4KB 到 64KB 的字符串, 偶尔带转义和多字节字符
+std::string make_strings(std::size_t bytes, std::mt19937_64& rng)
+{
+    std::string text = "[";
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        std::size_t length = 4096 + rng() % (60 * 1024);
+        text += i == 0 ? "\"" : ",\"";
+        for (std::size_t n = 0; n < length; n++) {
+            uint64_t r = rng() % 512;
+            if (r == 0) {
+                text += "\\n";
+            } else if (r == 1) {
+                text += "\\u00e9";
+            } else if (r == 2) {
+                text += "é";
+            } else {
+                text.push_back(static_cast<char>('a' + r % 26));
+            }
+        }
+        text += '"';
+    }
+    return text + "]";
+}
+
+//* 宽对象: 每个对象 200 个键, 超过小对象线性查找的范围, 需要建索引
+std::string make_wide(std::size_t bytes, std::mt19937_64& rng)
+{
+    std::string text = "[";
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        text += i == 0 ? "{" : ",{";
+        for (int k = 0; k < 200; k++) {
+            text += fmt::format(R"({}"field_{}":{})", k == 0 ? "" : ",", k, rng() % 100000);
+        }
+        text += '}';
+    }
+    return text + "]";
+}
+
+//* ---------- 测量 ----------
+
+//* /proc/self/status 里的一项(KB). 在 Linux 上把 VmHWM 清零后, 每个阶段的峰值减去开始时的 VmRSS 就是这个阶段多用的内存
+#ifdef __linux__
+std::size_t status_kb(const char* field)
+{
+    std::ifstream in("/proc/self/status");
+    std::string   line;
+    std::size_t   length = std::strlen(field);
+    while (std::getline(in, line)) {
+        if (line.compare(0, length, field) == 0) {
+            return std::strtoull(line.c_str() + length, nullptr, 10);
+        }
+    }
+    return 0;
+}
+std::size_t reset_peak_rss()
+{
+#    ifdef __GLIBC__
+    malloc_trim(0);  // 之前阶段释放的内存还给系统, 否则这一阶段复用它们不会体现在 RSS 上
+#    endif
+    std::ofstream("/proc/self/clear_refs") << "5";
+    return status_kb("VmRSS:");
+}
+std::size_t peak_rss_kb()
+{
+    return status_kb("VmHWM:");
+}
+#else
+std::size_t reset_peak_rss()
+{
+    return 0;
+}
+std::size_t peak_rss_kb()
+{
+    return 0;
+}
+#endif
+
+struct phase {
+    double      seconds = 0;  // 最好的一轮
+    std::size_t allocs  = 0;  // 每轮的堆分配次数
+    std::size_t rss_kb  = 0;  // 峰值 RSS 比开始时多出的部分
+};
+
+//* 至少跑 3 轮并且总共超过 0.5 秒, 取最快的一轮
+template <class F> phase measure(F&& run)
+{
+    phase       result;
+    double      total    = 0;
+    std::size_t baseline = reset_peak_rss();
+    for (int round = 0; round < 3 || total < 0.5; round++) {
+        std::size_t before = allocations.load();
+        auto        start  = std::chrono::steady_clock::now();
+        run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.allocs  = allocations.load() - before;
+        result.seconds = round == 0 ? seconds : std::min(result.seconds, seconds);
+        total += seconds;
+    }
+    result.rss_kb = std::max(peak_rss_kb(), baseline) - baseline;
+    return result;
+}
+
+//* 访问整棵树: 读出每个字符串和数字, 用显式的栈, 深层嵌套也不会爆调用栈
+double walk(const json_value& root)
+{
+    double                         sum = 0;
+    std::vector<const json_value*> stack{&root};
+    while (!stack.empty()) {
+        const json_value* v = stack.back();
+        stack.pop_back();
+        if (v->has_type<json_object>()) {
+            for (const auto& member : v->get_object()) {
+                sum += member.first.size();
+                stack.push_back(member.second);
+            }
+        } else if (v->has_type<json_array>()) {
+            for (const json_value* element : v->get_array()) {
+                stack.push_back(element);
+            }
+        } else if (v->has_type<json_string>()) {
+            sum += v->get_string_view().size();
+        } else if (v->has_type<double>() || v->has_type<int64_t>() || v->has_type<uint64_t>()) {
+            sum += v->get_number();
+        }
+    }
+    return sum;
+}
+
+struct result {
+    std::string name;
+    std::size_t bytes;
+    phase       parse, access, serialize;
+};
+
+result run_case(const std::string& name, const std::string& text)
+{
+    result r{name, text.size(), {}, {}, {}};
+    r.parse = measure([&] {
+        json_parser   parser(text.data(), text.size());
+        json_document doc = parser.parse();
+        checksum += doc.root().has_type<json_array>();
+    });
+    json_parser   parser(text.data(), text.size());
+    json_document doc = parser.parse();
+    r.access          = measure([&] { checksum += walk(doc.root()); });
+    r.serialize       = measure([&] { checksum += doc.to_string().size(); });
+    return r;
+}
+
+}  // namespace
+
+//* 统计整个程序的堆分配次数
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+    bool                     as_json = false;
+    std::size_t              scale   = 8;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            as_json = true;
+        } else if (arg == "--scale" && i + 1 < argc) {
+            scale = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--corpus") {
+            while (i + 1 < argc && argv[i + 1][0] != '-') {
+                files.push_back(argv[++i]);
+            }
+        } else {
+            std::cerr << "usage: bench_suite [--json] [--scale MB] [--corpus file.json ...]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::size_t     bytes = scale * 1000 * 1000;
+    std::mt19937_64 rng(7);
+    std::vector<std::pair<std::string, std::string>> corpus = {
+        {"twitter", make_twitter(bytes, rng)}, {"citm_catalog", make_citm(bytes, rng)}, {"canada", make_canada(bytes, rng)},
+        {"deep", make_deep(bytes, rng)},       {"strings", make_strings(bytes, rng)},   {"wide", make_wide(bytes, rng)},
+    };
+    for (const std::string& file : files) {
+        std::ifstream      in(file, std::ios::binary);
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        corpus.emplace_back(file, contents.str());
+    }
+
+    std::vector<result> results;
+    for (const auto& [name, text] : corpus) {
+        results.push_back(run_case(name, text));
+    }
+
+    auto mbps = [](const result& r, const phase& p) { return r.bytes / p.seconds / 1e6; };
+    if (as_json) {
+        json_writer writer(std::cout, 2);
+        writer.begin_object();
+        writer.key("implementation");
+        writer.string(json_structural_scanner::implementation());
+        writer.key("results");
+        writer.begin_array();
+        for (const result& r : results) {
+            writer.begin_object();
+            writer.key("corpus");
+            writer.string(r.name);
+            writer.key("bytes");
+            writer.number(uint64_t(r.bytes));
+            for (auto [label, p] : {std::pair{"parse", &r.parse}, std::pair{"access", &r.access}, std::pair{"serialize", &r.serialize}}) {
+                writer.key(label);
+                writer.begin_object();
+                writer.key("mb_per_s");
+                writer.number(mbps(r, *p));
+                writer.key("ms");
+                writer.number(p->seconds * 1e3);
+                writer.key("allocs_per_doc");
+                writer.number(uint64_t(p->allocs));
+                writer.key("peak_rss_growth_kb");
+                writer.number(uint64_t(p->rss_kb));
+                writer.end_object();
+            }
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.end_object();
+        writer.flush();
+        std::cout << std::endl;
+        return checksum == 0;
+    }
+
+    fmt::print("stage 1: {}\n", json_structural_scanner::implementation());
+    fmt::print("{:<14} {:>8} | {:>9} {:>9} {:>9} | {:>9} | {:>9} {:>9}\n", "corpus", "MB", "parse", "allocs", "+peak KB", "access", "serialize",
+               "allocs");
+    for (const result& r : results) {
+        fmt::print("{:<14} {:>8.1f} | {:>9.1f} {:>9} {:>9} | {:>9.1f} | {:>9.1f} {:>9}\n", r.name, r.bytes / 1e6, mbps(r, r.parse), r.parse.allocs,
+                   r.parse.rss_kb, mbps(r, r.access), mbps(r, r.serialize), r.serialize.allocs);
+    }
+    fmt::print("(MB/s; allocs are heap allocations per document; +peak KB is peak RSS growth during parse)\n");
+    return checksum == 0;
+}
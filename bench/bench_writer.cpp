@@ -0,0 +1,82 @@
+//* 序列化基准: DOM 与 tape 的紧凑/美化输出, 以及输出到流
+//* 用法: bench_writer [记录数]
+
+#include "../json_tape.hpp"
+#include "../json_writer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+//* 生成一个对象数组, 每条记录混合字符串、整数、浮点、布尔和嵌套容器
+std::string make_document(std::size_t records)
+{
+    std::mt19937_64                  rng(7);
+    std::uniform_real_distribution<> real(-1000.0, 1000.0);
+    std::string                      text = "[";
+    for (std::size_t i = 0; i < records; i++) {
+        if (i != 0) {
+            text.push_back(',');
+        }
+        text += fmt::format(R"({{"id":{},"name":"user_{}","email":"user{}@example.com","score":{},"ratio":{},)"
+                            R"("active":{},"tags":["a","b\n\"c\""],"pos":{{"x":{},"y":{}}},"note":null}})",
+                            rng() >> 1, i, rng() % 100000, real(rng), real(rng) / 7, rng() % 2 ? "true" : "false", real(rng), real(rng));
+    }
+    text.push_back(']');
+    return text;
+}
+
+template <class F> double measure(F&& run)
+{
+    constexpr int rounds = 5;
+    auto          start  = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        run();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t records = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    std::string text    = make_document(records);
+
+    json_parser   dom_parser(text.data(), text.size());
+    json_document doc = dom_parser.parse();
+    json_parser   tape_parser(text.data(), text.size());
+    json_tape     tape = tape_parser.parse_tape();
+
+    std::size_t   bytes = 0;
+    std::ofstream null_stream("/dev/null");
+    auto          report = [&](const char* name, double seconds) {
+        fmt::print("{:<20} {:>10.1f} MB/s {:>10.2f} ms\n", name, bytes / seconds / 1e6, seconds * 1e3);
+    };
+
+    fmt::print("input {:.1f} MB, {} records\n", text.size() / 1e6, records);
+    report("dom compact", measure([&] { bytes = doc.to_string().size(); }));
+    report("dom pretty", measure([&] { bytes = doc.to_string(4).size(); }));
+    report("tape compact", measure([&] { bytes = tape.to_string().size(); }));
+    report("tape pretty", measure([&] { bytes = tape.to_string(4).size(); }));
+    //* 复用同一个输出缓冲区, 不计扩容
+    std::string out;
+    report("dom reused buffer", measure([&] {
+               out.clear();
+               json_writer writer(out);
+               writer.write(doc.root());
+               bytes = out.size();
+           }));
+    report("dom to stream", measure([&] {
+               json_writer writer(null_stream);
+               writer.write(doc.root());
+           }));
+    return 0;
+}
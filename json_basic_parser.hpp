@@ -0,0 +1,315 @@
+#pragma once
+
+#include "json_parser.hpp"
+#include "json_sax.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+//* 数字交给 handler 之前怎么表示
+enum number_policy : uint8_t {
+    NUMBERS_EXACT  = 1,  // 与 json_parser 相同, 整数保持 int64/uint64
+    NUMBERS_DOUBLE = 2   // 一律转成 double
+};
+
+//* 字符串和键交给 handler 之前怎么处理
+enum string_policy : uint8_t {
+    STRINGS_DECODED = 1,  // 与 json_parser 相同, 解码转义, 视图只在回调期间有效
+    STRINGS_RAW     = 2   // 引号之间的原始字节, 转义原样保留也不检查, 视图在输入有效期间一直有效
+};
+
+//* 调用者持有的一段内存, 不拷贝, 必须比解析器活得长
+class json_memory_source {
+  public:
+    json_memory_source(const char* data, std::size_t size) : p(data), n(size) {}
+    explicit json_memory_source(const std::string& s) : p(s.data()), n(s.size()) {}
+
+    const char* data() const
+    {
+        return p;
+    }
+    std::size_t size() const
+    {
+        return n;
+    }
+
+  private:
+    const char* p;
+    std::size_t n;
+};  // class json_memory_source
+
+//* json_basic_parser 的编译期配置. 默认值与 json_parser 的行为相同;
+//* 自定义配置从它派生, 只重新声明要改的成员
+struct json_policy {
+    //* 数组和对象最后一个元素之后是否允许多一个逗号
+    static constexpr bool                 trailing_commas = false;
+    static constexpr number_policy        numbers         = NUMBERS_EXACT;
+    static constexpr string_policy        strings         = STRINGS_DECODED;
+    //* true 时出错抛出 json_parse_error; false 时 parse 返回 json_parse_result
+    static constexpr bool                 exceptions      = true;
+    //* 容器最多嵌套的层数, 0 表示不检查
+    static constexpr std::size_t          max_depth       = json_grammar::default_max_depth;
+    //* 只影响 parse(json_document&) 建树
+    static constexpr duplicate_key_policy duplicates      = DUPLICATE_KEY_LAST;
+    //* 输入: json_memory_source(data, size) 或 json_mapped_file(path), 构造解析器的参数原样转给它
+    using source = json_memory_source;
+};
+
+//* 只多允许末尾逗号
+struct json_relaxed_policy : json_policy {
+    static constexpr bool trailing_commas = true;
+};
+
+//* 检查和转换都减到最少: 字符串不解码, 数字都是 double, 不限制深度, 用返回值报错
+struct json_minimal_policy : json_policy {
+    static constexpr number_policy numbers    = NUMBERS_DOUBLE;
+    static constexpr string_policy strings    = STRINGS_RAW;
+    static constexpr bool          exceptions = false;
+    static constexpr std::size_t   max_depth  = 0;
+};
+
+enum parse_status : uint8_t {
+    PARSE_OK      = 1,
+    PARSE_STOPPED = 2,  // handler 返回了 false
+    PARSE_ERROR   = 4
+};
+
+//* 不抛异常的配置的解析结果. 出错时 offset 和 message 与 json_parse_error 的相同
+struct json_parse_result {
+    parse_status status = PARSE_OK;
+    std::size_t  offset = 0;
+    std::string  message;
+
+    bool ok() const
+    {
+        return status == PARSE_OK;
+    }
+};
+
+//* 按 Policy 在编译期特化的解析器. stage 1 与 json_parser 共用, stage 2 不经过 json_grammar 的状态机,
+//* 语法直接写成跳转: 每个位置只比较这里可能出现的 token, 配置关掉的检查和转换在编译时就被去掉.
+//* 不支持流式输入、统计和键驻留, 这些需要时用 json_parser
+template <class Policy = json_policy> class json_basic_parser {
+  public:
+    using policy = Policy;
+    //* 抛异常的配置返回 bool(handler 中途返回 false 时为 false), 否则返回 json_parse_result
+    using result_type = std::conditional_t<Policy::exceptions, bool, json_parse_result>;
+
+    //* 参数用来构造 Policy::source
+    template <class... Args>
+    explicit json_basic_parser(Args&&... args) : input(std::forward<Args>(args)...), token_reader(input.data(), input.size())
+    {
+    }
+    json_basic_parser(const json_basic_parser&) = delete;
+    json_basic_parser& operator=(const json_basic_parser&) = delete;
+
+    //* 换一段输入, 只用于 json_memory_source
+    void reset(const char* data, std::size_t size)
+    {
+        input = json_memory_source(data, size);
+        token_reader.reset(data, size);
+    }
+
+    //* handler 的接口与 json_sax_handler 相同, 可以是任何有同名成员函数的类型
+    template <class Handler> result_type parse(Handler& handler);
+    //* 建树, 同 json_parser::parse(json_document&). STRINGS_RAW 时树里存的是未解码的字符串
+    result_type parse(json_document& doc)
+    {
+        doc.clear();
+        //* 同 json_parser, 第一次也经过 reset 预留容器栈
+        if (builder == nullptr) {
+            builder = std::make_unique<json_document_builder>(doc, Policy::duplicates);
+        }
+        builder->reset(doc, Policy::duplicates);
+        return parse(*builder);
+    }
+    //* 只用于抛异常的配置
+    json_document parse()
+    {
+        static_assert(Policy::exceptions, "parse() without a document needs a policy that throws; use parse(json_document&)");
+        json_document doc;
+        parse(doc);
+        return doc;
+    }
+
+  private:
+    template <class Handler> bool run(Handler& handler);
+
+    std::string_view read_string()
+    {
+        if constexpr (Policy::strings == STRINGS_RAW) {
+            return token_reader.read_raw_string();
+        } else {
+            return token_reader.read_string();
+        }
+    }
+    json_number read_number()
+    {
+        if constexpr (Policy::numbers == NUMBERS_DOUBLE) {
+            //* 不区分整数, 直接解析成 double
+            json_number n;
+            n.type = NUMBER_DOUBLE;
+            n.d    = token_reader.read_double();
+            return n;
+        } else {
+            return token_reader.read_number();
+        }
+    }
+    //* 在 '[' 或 '{' 处调用, 超过深度时的位置就是这个括号
+    void push(bool object)
+    {
+        if constexpr (Policy::max_depth != 0) {
+            if (levels.size() >= Policy::max_depth) {
+                throw json_parse_error(fmt::format("Nesting too deep : more than {} levels", Policy::max_depth), token_reader.offset());
+            }
+        }
+        levels.push_back(object);
+    }
+
+    typename Policy::source                input;
+    json_token_reader                      token_reader;
+    std::vector<uint8_t>                   levels;  // 每层尚未闭合的容器是否为对象, 跨多次解析保留容量
+    std::unique_ptr<json_document_builder> builder;
+};  // class json_basic_parser
+
+template <class Policy> template <class Handler> auto json_basic_parser<Policy>::parse(Handler& handler) -> result_type
+{
+    if constexpr (Policy::exceptions) {
+        try {
+            return run(handler);
+        } catch (const json_parse_error& e) {
+            if (e.offset() != json_parse_error::npos) {
+                throw;
+            }
+            throw e.at(token_reader.offset());
+        }
+    } else {
+        json_parse_result result;
+        try {
+            result.status = run(handler) ? PARSE_OK : PARSE_STOPPED;
+        } catch (const json_parse_error& e) {
+            result.status  = PARSE_ERROR;
+            result.offset  = e.offset() != json_parse_error::npos ? e.offset() : token_reader.offset();
+            result.message = e.message();
+        }
+        return result;
+    }
+}
+
+//* 三个位置: value 期待一个值, key 期待对象的键, after_value 期待逗号、容器结尾或输入结尾.
+//* 语法错误时 token_reader 停在出错的 token 上, 由 parse 补上位置
+template <class Policy> template <class Handler> bool json_basic_parser<Policy>::run(Handler& handler)
+{
+    levels.clear();
+    levels.reserve(json_grammar::reserved_depth);
+    token_type token = token_reader.next_token();
+value:
+    switch (token) {
+        case BEGIN_OBJECT:
+            push(true);
+            token_reader.pass_char();
+            if (!handler.on_begin_object()) {
+                return false;
+            }
+            token = token_reader.next_token();
+            if (token == END_OBJECT) {
+                goto end_container;
+            }
+            goto key;
+        case BEGIN_ARRAY:
+            push(false);
+            token_reader.pass_char();
+            if (!handler.on_begin_array()) {
+                return false;
+            }
+            token = token_reader.next_token();
+            if (token == END_ARRAY) {
+                goto end_container;
+            }
+            goto value;
+        case STRING:
+            if (!handler.on_string(read_string())) {
+                return false;
+            }
+            goto after_value;
+        case NUMBER:
+            if (!handler.on_number(read_number())) {
+                return false;
+            }
+            goto after_value;
+        case BOOLEAN:
+            if (!handler.on_boolean(token_reader.read_boolean())) {
+                return false;
+            }
+            goto after_value;
+        case NULL_VALUE:
+            token_reader.read_null();
+            if (!handler.on_null()) {
+                return false;
+            }
+            goto after_value;
+        default: json_grammar::unexpected(token);
+    }
+key:
+    if (token != STRING) {
+        json_grammar::unexpected(token);
+    }
+    if (!handler.on_key(read_string())) {
+        return false;
+    }
+    token = token_reader.next_token();
+    if (token != SEP_COLON) {
+        json_grammar::unexpected(token);
+    }
+    token_reader.pass_char();
+    token = token_reader.next_token();
+    goto value;
+after_value:
+    token = token_reader.next_token();
+    if (levels.empty()) {
+        if (token != END_DOCUMENT) {
+            json_grammar::unexpected(token);
+        }
+        return true;
+    }
+    if (token == SEP_COMMA) {
+        token_reader.pass_char();
+        token = token_reader.next_token();
+        if constexpr (Policy::trailing_commas) {
+            if (token == (levels.back() ? END_OBJECT : END_ARRAY)) {
+                goto end_container;
+            }
+        }
+        if (levels.back()) {
+            goto key;
+        }
+        goto value;
+    }
+    if (token != (levels.back() ? END_OBJECT : END_ARRAY)) {
+        json_grammar::unexpected(token);
+    }
+end_container:
+    token_reader.pass_char();
+    if (levels.back()) {
+        levels.pop_back();
+        if (!handler.on_end_object()) {
+            return false;
+        }
+    } else {
+        levels.pop_back();
+        if (!handler.on_end_array()) {
+            return false;
+        }
+    }
+    goto after_value;
+}
+
+}  // namespace json
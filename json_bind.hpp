@@ -0,0 +1,521 @@
+#pragma once
+
+#include "json_parser.hpp"
+#include "json_sax.hpp"
+#include "json_writer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace json {
+
+//* 类型绑定: 结构体的字段只描述一次, 编译期生成直接从 json_token_reader 读进结构体的解析器, 不经过 json_value.
+//* 用法:
+//*     struct point { double x; double y; std::optional<std::string> label; };
+//*     JSON_BIND(point, x, y, label)                     // 在全局命名空间里写, 键名就是字段名
+//*     point p = json::json_bind<point>::parse(text.data(), text.size());
+//*     std::string s = json::json_bind<point>::to_string(p);
+//* 键名和字段名不同时手写特化:
+//*     template <> struct json::json_fields<point> {
+//*         static constexpr auto fields = std::make_tuple(json::field("X", &point::x), json::field("Y", &point::y));
+//*     };
+//* 支持的字段类型: bool、整数、浮点数、std::string、std::vector、std::map<std::string, T>、std::optional 和其他绑定过的结构体.
+//* std::optional 字段可以缺少或为 null, 写出时为空的字段被省略; 其他字段缺少时抛出异常. 未知的键被跳过, 重复的键后出现的覆盖前面的
+
+//* 一个字段: 键名和成员指针
+template <class C, class M> struct json_field {
+    std::string_view name;
+    M C::*member;
+};
+
+template <class C, class M> constexpr json_field<C, M> field(std::string_view name, M C::*member)
+{
+    return json_field<C, M>{name, member};
+}
+
+//* 每个绑定的类型特化一次, 提供 static constexpr 的 fields 元组
+template <class T> struct json_fields;
+
+namespace bind_detail {
+
+template <class T, class = void> struct is_bound : std::false_type {};
+template <class T> struct is_bound<T, std::void_t<decltype(json_fields<T>::fields)>> : std::true_type {};
+
+template <class T> struct is_optional : std::false_type {};
+template <class T> struct is_optional<std::optional<T>> : std::true_type {};
+
+//* 键的哈希: 带种子的 FNV-1a, 编译期选一个让所有键互不冲突的种子
+constexpr uint32_t key_hash(std::string_view key, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : key) {
+        h ^= uint8_t(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+struct hash_layout {
+    std::size_t size = 0;  // 槽数, 2 的幂; 0 表示没找到(键有重复)
+    uint32_t    seed = 0;
+};
+
+template <std::size_t N> constexpr std::size_t max_table_size()
+{
+    std::size_t size = 4;
+    while (size < N * 2) {
+        size *= 2;
+    }
+    return size * 16;
+}
+
+//* 从两倍键数开始找完美哈希, 找不到就把表加倍
+template <std::size_t N> constexpr hash_layout find_layout(const std::array<std::string_view, N>& names)
+{
+    constexpr std::size_t limit = max_table_size<N>();
+    for (std::size_t size = limit / 16; size <= limit; size *= 2) {
+        for (uint32_t seed = 0; seed < 256; seed++) {
+            std::array<bool, limit> used{};
+            bool                    perfect = true;
+            for (std::size_t i = 0; i < N && perfect; i++) {
+                std::size_t slot = key_hash(names[i], seed) & (size - 1);
+                perfect          = !used[slot];
+                used[slot]       = true;
+            }
+            if (perfect) {
+                return hash_layout{size, seed};
+            }
+        }
+    }
+    return hash_layout{};
+}
+
+//* 下一个 token, 跳过空白
+inline token_type next(json_token_reader& reader)
+{
+    token_type token = reader.next_token();
+    while (token == BLANK) {
+        reader.pass_char();
+        token = reader.next_token();
+    }
+    return token;
+}
+
+[[noreturn]] inline void mismatch(const char* expected)
+{
+    throw json_parse_error(fmt::format("json bind error : expected {}.", expected));
+}
+
+inline void expect(json_token_reader& reader, token_type token, const char* expected)
+{
+    if (next(reader) != token) {
+        mismatch(expected);
+    }
+    reader.pass_char();
+}
+
+//* 跳过一个不认识的值, 同时检查它的语法. 语法和嵌套深度交给 json_grammar, 不递归, 再深的值也不会用完调用栈
+inline void skip(json_token_reader& reader, token_type token)
+{
+    json_grammar grammar;
+    while (true) {
+        switch (token) {
+            case STRING:
+                grammar.string_is_key();
+                reader.read_string();
+                break;
+            case NUMBER:
+                grammar.value(NUMBER);
+                reader.read_number();
+                break;
+            case BOOLEAN:
+                grammar.value(BOOLEAN);
+                reader.read_boolean();
+                break;
+            case NULL_VALUE:
+                grammar.value(NULL_VALUE);
+                reader.read_null();
+                break;
+            case BEGIN_ARRAY: grammar.begin_array(); reader.pass_char(); break;
+            case BEGIN_OBJECT: grammar.begin_object(); reader.pass_char(); break;
+            case END_ARRAY: grammar.end_array(); reader.pass_char(); break;
+            case END_OBJECT: grammar.end_object(); reader.pass_char(); break;
+            case SEP_COLON: grammar.colon(); reader.pass_char(); break;
+            case SEP_COMMA: grammar.comma(); reader.pass_char(); break;
+            default: mismatch("value");
+        }
+        if (grammar.complete()) {
+            return;
+        }
+        token = next(reader);
+    }
+}
+
+//* 数组和对象的元素循环: token 是容器的起始 token, 每个元素调用一次 element(第一个 token)
+template <class F> void read_elements(json_token_reader& reader, token_type close, const char* separators, F&& element)
+{
+    reader.pass_char();
+    token_type token = next(reader);
+    if (token == close) {
+        reader.pass_char();
+        return;
+    }
+    while (true) {
+        element(token);
+        token = next(reader);
+        reader.pass_char();
+        if (token == close) {
+            return;
+        }
+        if (token != SEP_COMMA) {
+            mismatch(separators);
+        }
+        token = next(reader);
+    }
+}
+
+}  // namespace bind_detail
+
+//* 每种类型怎么读写: read 从已经取到的第一个 token 开始读一个值, write 写出一个值
+template <class T, class = void> struct json_binder;
+
+template <> struct json_binder<bool> {
+    static void read(json_token_reader& reader, token_type token, bool& out)
+    {
+        if (token != BOOLEAN) {
+            bind_detail::mismatch("boolean");
+        }
+        out = reader.read_boolean();
+    }
+    static void write(json_writer& writer, bool value)
+    {
+        writer.boolean(value);
+    }
+};
+
+template <class T> struct json_binder<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static void read(json_token_reader& reader, token_type token, T& out)
+    {
+        if (token != NUMBER) {
+            bind_detail::mismatch("integer");
+        }
+        json_number n = reader.read_number();
+        if (n.type == NUMBER_INT64 && n.i >= int64_t(std::numeric_limits<T>::min()) &&
+            (n.i < 0 || uint64_t(n.i) <= uint64_t(std::numeric_limits<T>::max()))) {
+            out = static_cast<T>(n.i);
+            return;
+        }
+        if (n.type == NUMBER_UINT64 && n.u <= uint64_t(std::numeric_limits<T>::max())) {
+            out = static_cast<T>(n.u);
+            return;
+        }
+        throw json_parse_error("json bind error : number is not an integer in range.");
+    }
+    static void write(json_writer& writer, T value)
+    {
+        if constexpr (std::is_signed_v<T>) {
+            writer.number(int64_t(value));
+        } else {
+            writer.number(uint64_t(value));
+        }
+    }
+};
+
+template <class T> struct json_binder<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static void read(json_token_reader& reader, token_type token, T& out)
+    {
+        if (token != NUMBER) {
+            bind_detail::mismatch("number");
+        }
+        out = static_cast<T>(reader.read_number().as_double());
+    }
+    static void write(json_writer& writer, T value)
+    {
+        writer.number(double(value));
+    }
+};
+
+template <> struct json_binder<std::string> {
+    static void read(json_token_reader& reader, token_type token, std::string& out)
+    {
+        if (token != STRING) {
+            bind_detail::mismatch("string");
+        }
+        std::string_view s = reader.read_string();
+        out.assign(s.data(), s.size());
+    }
+    static void write(json_writer& writer, const std::string& value)
+    {
+        writer.string(value);
+    }
+};
+
+template <class T> struct json_binder<std::optional<T>> {
+    static void read(json_token_reader& reader, token_type token, std::optional<T>& out)
+    {
+        if (token == NULL_VALUE) {
+            reader.read_null();
+            out.reset();
+            return;
+        }
+        json_binder<T>::read(reader, token, out.emplace());
+    }
+    static void write(json_writer& writer, const std::optional<T>& value)
+    {
+        if (value) {
+            json_binder<T>::write(writer, *value);
+        } else {
+            writer.null();
+        }
+    }
+};
+
+template <class T> struct json_binder<std::vector<T>> {
+    static void read(json_token_reader& reader, token_type token, std::vector<T>& out)
+    {
+        if (token != BEGIN_ARRAY) {
+            bind_detail::mismatch("array");
+        }
+        out.clear();
+        bind_detail::read_elements(reader, END_ARRAY, "',' or ']'", [&](token_type element) {
+            json_binder<T>::read(reader, element, out.emplace_back());
+        });
+    }
+    static void write(json_writer& writer, const std::vector<T>& value)
+    {
+        writer.begin_array();
+        for (const T& element : value) {
+            json_binder<T>::write(writer, element);
+        }
+        writer.end_array();
+    }
+};
+
+template <class T> struct json_binder<std::map<std::string, T>> {
+    static void read(json_token_reader& reader, token_type token, std::map<std::string, T>& out)
+    {
+        if (token != BEGIN_OBJECT) {
+            bind_detail::mismatch("object");
+        }
+        out.clear();
+        bind_detail::read_elements(reader, END_OBJECT, "',' or '}'", [&](token_type key) {
+            if (key != STRING) {
+                bind_detail::mismatch("object key");
+            }
+            T& value = out[std::string(reader.read_string())];
+            bind_detail::expect(reader, SEP_COLON, "':'");
+            json_binder<T>::read(reader, bind_detail::next(reader), value);
+        });
+    }
+    static void write(json_writer& writer, const std::map<std::string, T>& value)
+    {
+        writer.begin_object();
+        for (const auto& [key, element] : value) {
+            writer.key(key);
+            json_binder<T>::write(writer, element);
+        }
+        writer.end_object();
+    }
+};
+
+//* 绑定的结构体: 键经过编译期生成的完美哈希表找到字段下标, 再通过函数指针表读进对应的成员
+template <class T> struct json_binder<T, std::enable_if_t<bind_detail::is_bound<T>::value>> {
+    using fields_type = std::remove_const_t<decltype(json_fields<T>::fields)>;
+
+    static constexpr std::size_t count = std::tuple_size_v<fields_type>;
+
+    template <std::size_t... I> static constexpr std::array<std::string_view, count> make_names(std::index_sequence<I...>)
+    {
+        return {std::get<I>(json_fields<T>::fields).name...};
+    }
+    static constexpr std::array<std::string_view, count> names  = make_names(std::make_index_sequence<count>());
+    static constexpr bind_detail::hash_layout            layout = bind_detail::find_layout(names);
+    static_assert(layout.size != 0, "json_fields: duplicate key names");
+
+    //* 槽里存字段下标 + 1, 0 表示空
+    static constexpr std::array<uint16_t, layout.size> make_slots()
+    {
+        std::array<uint16_t, layout.size> slots{};
+        for (std::size_t i = 0; i < count; i++) {
+            slots[bind_detail::key_hash(names[i], layout.seed) & (layout.size - 1)] = static_cast<uint16_t>(i + 1);
+        }
+        return slots;
+    }
+    static constexpr std::array<uint16_t, layout.size> slots = make_slots();
+
+    template <std::size_t I> static void read_field(json_token_reader& reader, token_type token, T& out)
+    {
+        auto& member = out.*(std::get<I>(json_fields<T>::fields).member);
+        json_binder<std::remove_reference_t<decltype(member)>>::read(reader, token, member);
+    }
+    using reader_fn = void (*)(json_token_reader&, token_type, T&);
+    template <std::size_t... I> static constexpr std::array<reader_fn, count> make_readers(std::index_sequence<I...>)
+    {
+        return {&read_field<I>...};
+    }
+    static constexpr std::array<reader_fn, count> readers = make_readers(std::make_index_sequence<count>());
+
+    //* 不是 std::optional 的字段必须出现
+    template <std::size_t... I> static constexpr std::array<bool, count> make_required(std::index_sequence<I...>)
+    {
+        return {!bind_detail::is_optional<std::remove_reference_t<decltype(std::declval<T&>().*(std::get<I>(json_fields<T>::fields).member))>>::value...};
+    }
+    static constexpr std::array<bool, count> required = make_required(std::make_index_sequence<count>());
+
+    //* 键对应的字段下标, 不认识的键返回 count
+    static std::size_t find(std::string_view key)
+    {
+        uint16_t slot = slots[bind_detail::key_hash(key, layout.seed) & (layout.size - 1)];
+        return slot != 0 && names[slot - 1] == key ? slot - 1 : count;
+    }
+
+    static void read(json_token_reader& reader, token_type token, T& out)
+    {
+        if (token != BEGIN_OBJECT) {
+            bind_detail::mismatch("object");
+        }
+        std::array<bool, count> seen{};
+        bind_detail::read_elements(reader, END_OBJECT, "',' or '}'", [&](token_type key) {
+            if (key != STRING) {
+                bind_detail::mismatch("object key");
+            }
+            std::size_t i = find(reader.read_string());
+            bind_detail::expect(reader, SEP_COLON, "':'");
+            token_type value = bind_detail::next(reader);
+            if (i == count) {
+                bind_detail::skip(reader, value);
+                return;
+            }
+            readers[i](reader, value, out);
+            seen[i] = true;
+        });
+        for (std::size_t i = 0; i < count; i++) {
+            if (required[i] && !seen[i]) {
+                throw json_parse_error(fmt::format("json bind error : missing field {}", names[i]));
+            }
+        }
+    }
+
+    static void write(json_writer& writer, const T& value)
+    {
+        writer.begin_object();
+        std::apply([&](const auto&... fields) { (write_field(writer, fields, value), ...); }, json_fields<T>::fields);
+        writer.end_object();
+    }
+    template <class M> static void write_field(json_writer& writer, const json_field<T, M>& f, const T& value)
+    {
+        const M& member = value.*(f.member);
+        if constexpr (bind_detail::is_optional<M>::value) {
+            if (!member) {
+                return;
+            }
+        }
+        writer.key(f.name);
+        json_binder<M>::write(writer, member);
+    }
+};
+
+//* 读写一个绑定的类型: parse 从 token 直接构造, to_string/write 按字段顺序写出
+template <class T> class json_bind {
+  public:
+    static T parse(const char* data, std::size_t size)
+    {
+        json_token_reader reader(data, size);
+        T                 value{};
+        try {
+            json_binder<T>::read(reader, bind_detail::next(reader), value);
+            if (bind_detail::next(reader) != END_DOCUMENT) {
+                throw json_parse_error("json bind error : unexpected content after document.");
+            }
+        } catch (const json_parse_error& e) {
+            //* 类型不符等错误不带位置, 补上读到的位置
+            if (e.offset() != json_parse_error::npos) {
+                throw;
+            }
+            throw e.at(reader.offset());
+        }
+        return value;
+    }
+    //* 与 json_parser(std::string&) 一样, 参数是文件路径
+    static T parse(std::string& path)
+    {
+        json_mapped_file file(path);
+        return parse(file.data(), file.size());
+    }
+
+    static std::string to_string(const T& value, int indent = 0)
+    {
+        std::string out;
+        {
+            json_writer writer(out, indent);
+            json_binder<T>::write(writer, value);
+        }
+        return out;
+    }
+    static void write(json_writer& writer, const T& value)
+    {
+        json_binder<T>::write(writer, value);
+    }
+};  // class json_bind
+
+}  // namespace json
+
+//* JSON_BIND(type, field...): 键名与字段名相同的绑定, 最多 32 个字段, 必须写在全局命名空间
+#define JSON_BIND_FIELD(type, m) ::json::field(#m, &type::m)
+#define JSON_BIND_EACH_1(t, m) JSON_BIND_FIELD(t, m)
+#define JSON_BIND_EACH_2(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_1(t, __VA_ARGS__)
+#define JSON_BIND_EACH_3(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_2(t, __VA_ARGS__)
+#define JSON_BIND_EACH_4(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_3(t, __VA_ARGS__)
+#define JSON_BIND_EACH_5(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_4(t, __VA_ARGS__)
+#define JSON_BIND_EACH_6(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_5(t, __VA_ARGS__)
+#define JSON_BIND_EACH_7(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_6(t, __VA_ARGS__)
+#define JSON_BIND_EACH_8(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_7(t, __VA_ARGS__)
+#define JSON_BIND_EACH_9(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_8(t, __VA_ARGS__)
+#define JSON_BIND_EACH_10(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_9(t, __VA_ARGS__)
+#define JSON_BIND_EACH_11(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_10(t, __VA_ARGS__)
+#define JSON_BIND_EACH_12(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_11(t, __VA_ARGS__)
+#define JSON_BIND_EACH_13(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_12(t, __VA_ARGS__)
+#define JSON_BIND_EACH_14(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_13(t, __VA_ARGS__)
+#define JSON_BIND_EACH_15(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_14(t, __VA_ARGS__)
+#define JSON_BIND_EACH_16(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_15(t, __VA_ARGS__)
+#define JSON_BIND_EACH_17(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_16(t, __VA_ARGS__)
+#define JSON_BIND_EACH_18(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_17(t, __VA_ARGS__)
+#define JSON_BIND_EACH_19(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_18(t, __VA_ARGS__)
+#define JSON_BIND_EACH_20(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_19(t, __VA_ARGS__)
+#define JSON_BIND_EACH_21(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_20(t, __VA_ARGS__)
+#define JSON_BIND_EACH_22(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_21(t, __VA_ARGS__)
+#define JSON_BIND_EACH_23(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_22(t, __VA_ARGS__)
+#define JSON_BIND_EACH_24(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_23(t, __VA_ARGS__)
+#define JSON_BIND_EACH_25(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_24(t, __VA_ARGS__)
+#define JSON_BIND_EACH_26(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_25(t, __VA_ARGS__)
+#define JSON_BIND_EACH_27(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_26(t, __VA_ARGS__)
+#define JSON_BIND_EACH_28(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_27(t, __VA_ARGS__)
+#define JSON_BIND_EACH_29(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_28(t, __VA_ARGS__)
+#define JSON_BIND_EACH_30(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_29(t, __VA_ARGS__)
+#define JSON_BIND_EACH_31(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_30(t, __VA_ARGS__)
+#define JSON_BIND_EACH_32(t, m, ...) JSON_BIND_FIELD(t, m), JSON_BIND_EACH_31(t, __VA_ARGS__)
+#define JSON_BIND_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, \
+                         _26, _27, _28, _29, _30, _31, _32, N, ...)                                                                        \
+    N
+#define JSON_BIND_COUNT(...) \
+    JSON_BIND_COUNT_(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define JSON_BIND_CAT_(a, b) a##b
+#define JSON_BIND_CAT(a, b) JSON_BIND_CAT_(a, b)
+
+#define JSON_BIND(type, ...)                                                                                               \
+    namespace json {                                                                                                       \
+    template <> struct json_fields<type> {                                                                                 \
+        static constexpr auto fields = std::make_tuple(JSON_BIND_CAT(JSON_BIND_EACH_, JSON_BIND_COUNT(__VA_ARGS__))(type, __VA_ARGS__)); \
+    };                                                                                                                     \
+    }
@@ -0,0 +1,234 @@
+#include "json_cache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace json;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+//* 缓存文件名用的哈希, 与实现无关, 换一个标准库编译出来的程序也能找到同一个文件
+uint64_t fnv1a(std::string_view s)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (char c : s) {
+        h ^= uint8_t(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string normalize(const std::string& path)
+{
+    std::error_code ec;
+    fs::path        p = fs::absolute(path, ec);
+    return ec ? path : p.lexically_normal().string();
+}
+
+//* 逐个检查映射回来的 tape: 标签合法, 容器的首尾互相指向并且计数正确, 对象的键都是字符串,
+//* 字符串偏移和长度落在字符串区内, 整个 tape 恰好是一个值. 通过之后视图的任何访问都不会越界
+bool valid_tape(const uint64_t* words, std::size_t word_count, const char* strings, std::size_t string_size)
+{
+    struct level {
+        uint32_t open;
+        uint32_t count;  // 已经读完的元素(对象为成员)个数
+        bool     object;
+        bool     expect_key;
+    };
+    constexpr uint64_t low56 = (uint64_t(1) << 56) - 1;
+    std::vector<level> stack;
+    std::size_t        i = 0;
+    do {
+        if (i >= word_count) {
+            return false;
+        }
+        tape_tag t       = static_cast<tape_tag>(words[i] >> 56);
+        uint64_t payload = words[i] & low56;
+        if (t == TAPE_END_OBJECT || t == TAPE_END_ARRAY) {
+            if (stack.empty() || stack.back().object != (t == TAPE_END_OBJECT) || !stack.back().expect_key || payload != stack.back().open) {
+                return false;
+            }
+            uint64_t begin = words[stack.back().open] & low56;
+            if ((begin & 0xFFFFFFFF) != i + 1 || (begin >> 32) != std::min<uint32_t>(stack.back().count, 0xFFFFFF)) {
+                return false;
+            }
+            stack.pop_back();
+            i++;
+        } else if (!stack.empty() && stack.back().object && stack.back().expect_key) {
+            //* 对象里轮到键
+            if (t != TAPE_STRING) {
+                return false;
+            }
+            stack.back().expect_key = false;
+        } else {
+            //* 一个值; 对象里的值读完以后轮到下一个键
+            if (!stack.empty()) {
+                stack.back().count++;
+                stack.back().expect_key = true;
+            }
+            switch (t) {
+                case TAPE_BEGIN_OBJECT:
+                case TAPE_BEGIN_ARRAY:
+                    //* 闭合位置和计数在遇到结尾时核对
+                    stack.push_back(level{static_cast<uint32_t>(i), 0, t == TAPE_BEGIN_OBJECT, true});
+                    i++;
+                    continue;
+                case TAPE_STRING: break;
+                case TAPE_DOUBLE:
+                case TAPE_INT64:
+                case TAPE_UINT64:
+                    if (i + 1 >= word_count) {
+                        return false;
+                    }
+                    i += 2;
+                    continue;
+                case TAPE_TRUE:
+                case TAPE_FALSE:
+                case TAPE_NULL: i++; continue;
+                default: return false;
+            }
+        }
+        if (t == TAPE_STRING) {
+            uint32_t length;
+            if (payload > string_size || string_size - payload < sizeof(length)) {
+                return false;
+            }
+            std::memcpy(&length, strings + payload, sizeof(length));
+            if (string_size - payload - sizeof(length) < length) {
+                return false;
+            }
+            i++;
+        }
+    } while (!stack.empty());
+    return i == word_count;
+}
+
+}  // namespace
+
+// class json_cached_tape
+json_tape_view json_cached_tape::root() const
+{
+    if (words == nullptr) {
+        throw std::runtime_error("json document is empty.");
+    }
+    return json_tape_view(words, strings, 0);
+}
+// class json_cached_tape
+
+// class json_tape_cache
+json_tape_cache::json_tape_cache(std::string directory) : directory(std::move(directory))
+{
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+}
+std::string json_tape_cache::cache_path(const std::string& path) const
+{
+    return (fs::path(directory) / fmt::format("{:016x}.tape", fnv1a(normalize(path)))).string();
+}
+json_cached_tape json_tape_cache::load(std::string& path)
+{
+    std::string     source = normalize(path);
+    std::string     file   = cache_path(path);
+    header          expected{};
+    std::error_code size_error, time_error;
+    std::memcpy(expected.magic, magic, sizeof(magic));
+    expected.version      = version;
+    expected.path_size    = static_cast<uint32_t>(source.size());
+    expected.source_size  = fs::file_size(path, size_error);
+    expected.source_mtime = fs::last_write_time(path, time_error).time_since_epoch().count();
+
+    json_cached_tape out;
+    //* 取不到大小或时间时不用缓存, 交给解析器报告打不开文件之类的错误
+    bool usable = !size_error && !time_error;
+    if (usable && open(file, source, expected, out)) {
+        return out;
+    }
+    json_parser parser(path);
+    out.tape    = std::make_shared<json_tape>(parser.parse_tape());
+    out.words   = out.tape->words.data();
+    out.strings = out.tape->strings.data();
+    if (usable) {
+        store(file, source, expected, *out.tape);
+    }
+    return out;
+}
+bool json_tape_cache::open(const std::string& file, const std::string& source, const header& expected, json_cached_tape& out) const
+{
+    std::error_code ec;
+    if (!fs::is_regular_file(file, ec)) {
+        return false;
+    }
+    std::shared_ptr<json_mapped_file> mapped;
+    try {
+        //* 视图按下标跳着读 tape, 不提示顺序预读
+        mapped = std::make_shared<json_mapped_file>(file, false);
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    const char* data = mapped->data();
+    std::size_t size = mapped->size();
+    header      h;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&h, data, sizeof(header));
+    if (std::memcmp(h.magic, expected.magic, sizeof(h.magic)) != 0 || h.version != expected.version || h.path_size != expected.path_size ||
+        h.source_size != expected.source_size || h.source_mtime != expected.source_mtime) {
+        return false;
+    }
+    std::size_t words_at = sizeof(header) + padded(h.path_size);
+    if (size < words_at || std::string_view(data + sizeof(header), h.path_size) != source) {
+        return false;
+    }
+    //* 长度必须与文件大小严格吻合, 截断或写了一半的文件都不用
+    if (h.word_count == 0 || h.word_count > (size - words_at) / sizeof(uint64_t) ||
+        h.string_size != size - words_at - h.word_count * sizeof(uint64_t)) {
+        return false;
+    }
+    const uint64_t* words   = reinterpret_cast<const uint64_t*>(data + words_at);
+    const char*     strings = data + words_at + h.word_count * sizeof(uint64_t);
+    //* 内容损坏(或被改过)的缓存与过期的一样处理, 由调用者重新解析
+    if (!valid_tape(words, h.word_count, strings, h.string_size)) {
+        return false;
+    }
+    out.words   = words;
+    out.strings = strings;
+    out.file    = std::move(mapped);
+    return true;
+}
+void json_tape_cache::store(const std::string& file, const std::string& source, header h, const json_tape& tape) const
+{
+    h.word_count  = tape.words.size();
+    h.string_size = tape.strings.size();
+
+    std::string tmp = fmt::format("{}.{:x}.tmp", file, std::hash<std::thread::id>()(std::this_thread::get_id()) ^
+                                                           std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        const char    zeros[8] = {};
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(source.data(), source.size());
+        out.write(zeros, padded(source.size()) - source.size());
+        out.write(reinterpret_cast<const char*>(tape.words.data()), tape.words.size() * sizeof(uint64_t));
+        out.write(tape.strings.data(), tape.strings.size());
+        out.close();
+        if (out) {
+            std::error_code ec;
+            fs::rename(tmp, file, ec);
+            if (!ec) {
+                return;
+            }
+        }
+    }
+    std::error_code ec;
+    fs::remove(tmp, ec);
+}
+// class json_tape_cache
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "json_tape.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+//* 从缓存映射出来或刚解析出来的 tape, 只读. 可以拷贝, 拷贝共享同一份数据
+class json_cached_tape {
+  public:
+    json_tape_view root() const;
+
+    json_tape_view operator[](std::string_view key) const
+    {
+        return root()[key];
+    }
+    json_tape_view operator[](std::size_t index) const
+    {
+        return root()[index];
+    }
+
+    std::string to_string(int indent = 0) const
+    {
+        return root().to_string(indent);
+    }
+
+    //* 这次是直接映射的缓存文件, 没有解析
+    bool from_cache() const
+    {
+        return file != nullptr;
+    }
+
+  private:
+    friend class json_tape_cache;
+
+    std::shared_ptr<json_mapped_file> file;  // 命中缓存时持有映射
+    std::shared_ptr<json_tape>        tape;  // 没有命中并且缓存写不进去时持有解析结果
+    const uint64_t*                   words   = nullptr;
+    const char*                       strings = nullptr;
+};  // class json_cached_tape
+
+//* 解析结果的磁盘缓存: tape 本身不含指针, 原样写进文件, 之后 mmap 回来就能直接用, 不需要任何解析.
+//* 缓存文件按源文件的路径命名, 里面记录源文件的大小和修改时间, 两者都没变时才认为缓存有效;
+//* 源文件被改写但大小和修改时间都相同的情况检测不到.
+//* 缓存只是加速手段: 缓存文件损坏时重新解析, 写不进去时照常返回解析结果
+class json_tape_cache {
+  public:
+    //* 缓存文件放在 directory 下, 目录不存在时创建
+    explicit json_tape_cache(std::string directory);
+
+    //* path 的 tape: 缓存有效时直接映射, 否则用 json_parser 解析并写入缓存
+    json_cached_tape load(std::string& path);
+    //* path 对应的缓存文件
+    std::string cache_path(const std::string& path) const;
+
+  private:
+    //* 缓存文件开头的固定部分, 后面依次是源文件的路径(补齐到 8 字节)、tape 和字符串缓冲区
+    struct header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t path_size;
+        uint64_t source_size;
+        int64_t  source_mtime;  // 文件系统时钟的计数
+        uint64_t word_count;
+        uint64_t string_size;
+        uint64_t reserved[2];
+    };
+    static constexpr char     magic[8] = {'J', 'S', 'O', 'N', 'T', 'A', 'P', 'E'};
+    static constexpr uint32_t version  = 1;
+
+    static std::size_t padded(std::size_t size)
+    {
+        return (size + 7) & ~std::size_t(7);
+    }
+    //* 检查映射出来的缓存文件, 有效时填好 out 并返回 true
+    bool open(const std::string& file, const std::string& source, const header& expected, json_cached_tape& out) const;
+    //* 写到临时文件再改名, 其他进程不会读到写了一半的缓存
+    void store(const std::string& file, const std::string& source, header h, const json_tape& tape) const;
+
+    std::string directory;
+};  // class json_tape_cache
+
+}  // namespace json
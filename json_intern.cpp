@@ -0,0 +1,48 @@
+#include "json_intern.hpp"
+
+#include <cstring>
+#include <mutex>
+
+using namespace json;
+
+// class json_key_table
+json_key json_key_table::intern(std::string_view s, std::size_t hash)
+{
+    shard& sh = shard_of(hash);
+    {
+        std::shared_lock<std::shared_mutex> guard(sh.lock);
+        auto                                it = sh.entries.find(hashed{s, hash});
+        if (it != sh.entries.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> guard(sh.lock);
+    auto                                it = sh.entries.find(hashed{s, hash});
+    if (it != sh.entries.end()) {
+        return it->second;
+    }
+    void*            p = sh.storage.allocate(sizeof(json_key::entry) + s.size(), alignof(json_key::entry));
+    json_key::entry* e = new (p) json_key::entry{hash, this, static_cast<uint32_t>(s.size())};
+    std::memcpy(e + 1, s.data(), s.size());
+    json_key key(e);
+    sh.entries.emplace(hashed{key.str(), hash}, key);
+    return key;
+}
+json_key json_key_table::find(std::string_view s) const
+{
+    std::size_t                         hash = std::hash<std::string_view>()(s);
+    const shard&                        sh   = shard_of(hash);
+    std::shared_lock<std::shared_mutex> guard(sh.lock);
+    auto                                it = sh.entries.find(hashed{s, hash});
+    return it != sh.entries.end() ? it->second : json_key();
+}
+std::size_t json_key_table::size() const
+{
+    std::size_t n = 0;
+    for (const shard& sh : shards) {
+        std::shared_lock<std::shared_mutex> guard(sh.lock);
+        n += sh.entries.size();
+    }
+    return n;
+}
+// class json_key_table
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "json_parser.hpp"
+
+#include <array>
+#include <cstddef>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace json {
+
+//* 键的驻留表: 每个不同的键只存一份, 带着算好的哈希值. 可以被多个解析器、多个线程共用,
+//* 表按哈希分成若干片, 每片一把读写锁, 已经存在的键只需要读锁.
+//* 条目只增不减, 表活多久键就有效多久; 用它解析出来的文档持有表的 shared_ptr
+class json_key_table {
+  public:
+    json_key_table() = default;
+    json_key_table(const json_key_table&) = delete;
+    json_key_table& operator=(const json_key_table&) = delete;
+
+    //* 返回 s 的驻留键, 不存在时插入. 线程安全
+    json_key intern(std::string_view s)
+    {
+        return intern(s, std::hash<std::string_view>()(s));
+    }
+    //* hash 必须是 std::hash<std::string_view>()(s), 调用者已经算过时省去一次
+    json_key intern(std::string_view s, std::size_t hash);
+    //* 只查不插, 不存在时返回空的 json_key. 线程安全
+    json_key find(std::string_view s) const;
+
+    //* 不同键的个数
+    std::size_t size() const;
+
+  private:
+    struct hashed {
+        std::string_view text;
+        std::size_t      hash;
+
+        bool operator==(const hashed& other) const
+        {
+            return text == other.text;
+        }
+    };
+    struct hashed_hash {
+        std::size_t operator()(const hashed& h) const
+        {
+            return h.hash;
+        }
+    };
+    struct shard {
+        mutable std::shared_mutex                         lock;
+        std::unordered_map<hashed, json_key, hashed_hash> entries;
+        json_arena                                        storage;  // 条目和键的字节
+    };
+
+    static constexpr std::size_t shard_count = 16;
+
+    shard& shard_of(std::size_t hash)
+    {
+        return shards[(hash >> 7) % shard_count];
+    }
+    const shard& shard_of(std::size_t hash) const
+    {
+        return shards[(hash >> 7) % shard_count];
+    }
+
+    std::array<shard, shard_count> shards;
+};  // class json_key_table
+
+}  // namespace json
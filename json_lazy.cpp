@@ -0,0 +1,325 @@
+#include "json_lazy.hpp"
+
+#include <cstring>
+
+using namespace json;
+
+namespace {
+
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline const char* skip_space(const char* p, const char* end)
+{
+    while (p < end && is_space(*p)) {
+        p++;
+    }
+    return p;
+}
+
+[[noreturn]] void unexpected(const char* p, const char* end)
+{
+    if (p >= end) {
+        throw std::runtime_error("Unexpected end of document.");
+    }
+    throw std::runtime_error(fmt::format("Unexpected json char : {}", *p));
+}
+
+//* open 指向起始引号, 返回结束引号的位置; escaped 记录中间有没有转义
+const char* string_end(const char* open, const char* end, bool& escaped)
+{
+    const char* p = open + 1;
+    escaped       = false;
+    while (true) {
+        p = find_string_special(p, end);
+        if (p == end) {
+            throw std::runtime_error("Unterminated string");
+        }
+        if (*p == '"') {
+            return p;
+        }
+        if (*p != '\\') {
+            throw std::runtime_error(fmt::format("Unescaped control character in string : {:#04x}", int(uint8_t(*p))));
+        }
+        //* 输入以反斜杠结尾时不能再往后跳
+        if (end - p < 2) {
+            throw std::runtime_error("Unterminated string");
+        }
+        escaped = true;
+        p += 2;
+    }
+}
+
+//* 解码 (open, close) 之间的字符串内容
+std::string decode(const char* open, const char* close, bool escaped)
+{
+    const char* begin = open + 1;
+    if (!validate_utf8(begin, close - begin)) {
+        throw std::runtime_error("Invalid UTF-8 in json input");
+    }
+    if (!escaped) {
+        return std::string(begin, close);
+    }
+    const char* p = find_string_special(begin, close);
+    std::string out(begin, p);
+    while (p < close) {
+        p               = decode_escape(p, close, out);
+        const char* run = find_string_special(p, close);
+        out.append(p, run);
+        p = run;
+    }
+    return out;
+}
+
+//* 标量之后必须紧跟空白、结构字符或输入结尾
+inline void check_delimiter(const char* p, const char* end)
+{
+    if (p < end && !is_space(*p) && *p != ',' && *p != ']' && *p != '}') {
+        unexpected(p, end);
+    }
+}
+
+//* 8 个字节中等于 '"'、'['、']'、'{' 或 '}' 的字节, 对应字节的最高位置 1
+inline uint64_t bracket_mask(uint64_t x)
+{
+    constexpr uint64_t ones  = 0x0101010101010101ULL;
+    constexpr uint64_t highs = 0x8080808080808080ULL;
+    uint64_t           q     = x ^ (ones * '"');
+    uint64_t           lower = x | (ones * 0x20);  // '[' ']' 和 '{' '}' 只差 0x20 这一位
+    uint64_t           open  = lower ^ (ones * '{');
+    uint64_t           close = lower ^ (ones * '}');
+    return (((q - ones) & ~q) | ((open - ones) & ~open) | ((close - ones) & ~close)) & highs;
+}
+
+//* 下一个引号或括号的位置, 没有则返回 end. 跳过子树时其余字节都不用看
+const char* next_bracket(const char* p, const char* end)
+{
+    uint64_t x;
+    for (; p + 8 <= end; p += 8) {
+        std::memcpy(&x, p, sizeof(x));
+        uint64_t mask = bracket_mask(x);
+        if (mask != 0) {
+            return p + __builtin_ctzll(mask) / 8;
+        }
+    }
+    while (p < end && *p != '"' && (*p | 0x20) != '{' && (*p | 0x20) != '}') {
+        p++;
+    }
+    return p;
+}
+
+//* 跳过 p 处的整个值, 返回它之后的位置. 容器只做括号配对, 不检查内部的语法
+const char* skip_value(const char* p, const char* end)
+{
+    bool escaped;
+    switch (*p) {
+        case '"': return string_end(p, end, escaped) + 1;
+        case '[':
+        case '{': {
+            std::size_t depth = 0;
+            while ((p = next_bracket(p, end)) < end) {
+                if (*p == '"') {
+                    p = string_end(p, end, escaped) + 1;
+                    continue;
+                }
+                if ((*p | 0x20) == '{') {
+                    depth++;
+                } else if (--depth == 0) {
+                    return p + 1;
+                }
+                p++;
+            }
+            throw std::runtime_error("Unexpected end of document.");
+        }
+        default: {
+            const char* q = p;
+            while (q < end && !is_space(*q) && *q != ',' && *q != ']' && *q != '}') {
+                q++;
+            }
+            if (q == p) {
+                unexpected(p, end);
+            }
+            return q;
+        }
+    }
+}
+
+//* p 指向键的起始引号, 判断它是否等于 key, 返回结束引号之后的位置
+const char* match_key(const char* p, const char* end, std::string_view key, bool& matched)
+{
+    bool        escaped;
+    const char* close = string_end(p, end, escaped);
+    if (!escaped) {
+        matched = std::string_view(p + 1, close - p - 1) == key;
+    } else {
+        matched = decode(p, close, true) == key;
+    }
+    return close + 1;
+}
+
+}  // namespace
+
+// class json_lazy_value
+json_lazy_value json_lazy_value::operator[](std::string_view key) const
+{
+    if (*p != '{') {
+        throw std::runtime_error("json access object error.");
+    }
+    const char* q = skip_space(p + 1, end);
+    if (q < end && *q == '}') {
+        throw std::runtime_error("json access object error : key not found");
+    }
+    while (true) {
+        if (q >= end || *q != '"') {
+            unexpected(q, end);
+        }
+        bool matched;
+        q = skip_space(match_key(q, end, key, matched), end);
+        if (q >= end || *q != ':') {
+            unexpected(q, end);
+        }
+        q = skip_space(q + 1, end);
+        if (q >= end) {
+            unexpected(q, end);
+        }
+        if (matched) {
+            return json_lazy_value(q, end);
+        }
+        q = skip_space(skip_value(q, end), end);
+        if (q < end && *q == ',') {
+            q = skip_space(q + 1, end);
+            continue;
+        }
+        if (q < end && *q == '}') {
+            throw std::runtime_error("json access object error : key not found");
+        }
+        unexpected(q, end);
+    }
+}
+json_lazy_value json_lazy_value::operator[](std::size_t index) const
+{
+    if (*p != '[') {
+        throw std::runtime_error("json access arrary error.");
+    }
+    const char* q = skip_space(p + 1, end);
+    if (q < end && *q == ']') {
+        throw std::runtime_error("json access array error : index out of range");
+    }
+    for (std::size_t i = 0;; i++) {
+        if (q >= end) {
+            unexpected(q, end);
+        }
+        if (i == index) {
+            return json_lazy_value(q, end);
+        }
+        q = skip_space(skip_value(q, end), end);
+        if (q < end && *q == ',') {
+            q = skip_space(q + 1, end);
+            continue;
+        }
+        if (q < end && *q == ']') {
+            throw std::runtime_error("json access array error : index out of range");
+        }
+        unexpected(q, end);
+    }
+}
+std::string json_lazy_value::get_string() const
+{
+    if (*p != '"') {
+        throw std::runtime_error("json access string error.");
+    }
+    bool        escaped;
+    const char* close = string_end(p, end, escaped);
+    return decode(p, close, escaped);
+}
+json_number json_lazy_value::number() const
+{
+    if (*p != '-' && (*p < '0' || *p > '9')) {
+        throw std::runtime_error("json access number error.");
+    }
+    json_number n;
+    check_delimiter(parse_number(p, end, n), end);
+    return n;
+}
+double json_lazy_value::get_number() const
+{
+    return number().as_double();
+}
+int64_t json_lazy_value::get_int64() const
+{
+    json_number n = number();
+    if (n.type == NUMBER_INT64) {
+        return n.i;
+    }
+    throw std::runtime_error("json access number error : not an int64.");
+}
+uint64_t json_lazy_value::get_uint64() const
+{
+    json_number n = number();
+    if (n.type == NUMBER_UINT64) {
+        return n.u;
+    }
+    if (n.type == NUMBER_INT64 && n.i >= 0) {
+        return static_cast<uint64_t>(n.i);
+    }
+    throw std::runtime_error("json access number error : not an uint64.");
+}
+bool json_lazy_value::is_integer() const
+{
+    return (*p == '-' || (*p >= '0' && *p <= '9')) && number().is_integer();
+}
+bool json_lazy_value::get_boolean() const
+{
+    std::size_t avail = end - p;
+    if (avail >= 4 && std::memcmp(p, "true", 4) == 0) {
+        check_delimiter(p + 4, end);
+        return true;
+    }
+    if (avail >= 5 && std::memcmp(p, "false", 5) == 0) {
+        check_delimiter(p + 5, end);
+        return false;
+    }
+    throw std::runtime_error("json access boolean error.");
+}
+bool json_lazy_value::is_null() const
+{
+    if (end - p < 4 || std::memcmp(p, "null", 4) != 0) {
+        return false;
+    }
+    check_delimiter(p + 4, end);
+    return true;
+}
+std::string_view json_lazy_value::raw() const
+{
+    return std::string_view(p, skip_value(p, end) - p);
+}
+json_document json_lazy_value::parse() const
+{
+    std::string_view text = raw();
+    json_parser      parser(text.data(), text.size());
+    return parser.parse();
+}
+std::string json_lazy_value::to_string(int indent) const
+{
+    return parse().to_string(indent);
+}
+// class json_lazy_value
+
+// class json_lazy_document
+json_lazy_document::json_lazy_document(std::string& path) : file(std::make_shared<json_mapped_file>(path))
+{
+    first = file->data();
+    last  = first + file->size();
+}
+json_lazy_document::json_lazy_document(const char* data, std::size_t size) : first(data), last(data + size) {}
+json_lazy_value json_lazy_document::root() const
+{
+    const char* p = skip_space(first, last);
+    if (p == last) {
+        throw std::runtime_error("json document is empty.");
+    }
+    return json_lazy_value(p, last);
+}
+// class json_lazy_document
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "json_parser.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+//* 按需访问: 不建树, 每次 operator[] 都从容器开头在原始文本上往后走, 不需要的键和元素按括号匹配整段跳过,
+//* 只有真正读到的值才会被解析. 只读几个字段时比 parse() 快得多.
+//* 只校验访问路径上经过的部分: 被跳过的子树只要求括号和字符串配对, 需要完整校验时对它调用 parse().
+//* 值只是指向输入的一对指针, 可以随意拷贝, 在 json_lazy_document 销毁前有效.
+//* 对象里有重复的键时返回第一个
+class json_lazy_value {
+  public:
+    json_lazy_value operator[](std::string_view key) const;
+    json_lazy_value operator[](std::size_t index) const;
+
+    std::string get_string() const;
+    //* 与 json_value 相同: 任意数字都可以按 double 读取, 整数只有在对应类型范围内时才能按整数读取
+    double   get_number() const;
+    int64_t  get_int64() const;
+    uint64_t get_uint64() const;
+    bool     is_integer() const;
+    bool     get_boolean() const;
+    bool     is_null() const;
+
+    //* 这个值在输入中的原始文本
+    std::string_view raw() const;
+    //* 完整解析(并校验)这个子树
+    json_document parse() const;
+    std::string   to_string(int indent = 0) const;
+
+  private:
+    friend class json_lazy_document;
+    json_lazy_value(const char* p, const char* end) : p(p), end(end) {}
+
+    json_number number() const;
+
+    const char* p;    // 值的第一个字节
+    const char* end;  // 输入的结尾
+};  // class json_lazy_value
+
+//* 按需访问的文档, 持有输入; 构造时不做任何解析
+class json_lazy_document {
+  public:
+    explicit json_lazy_document(std::string& path);
+    json_lazy_document(const char* data, std::size_t size);
+
+    json_lazy_value root() const;
+
+    json_lazy_value operator[](std::string_view key) const
+    {
+        return root()[key];
+    }
+    json_lazy_value operator[](std::size_t index) const
+    {
+        return root()[index];
+    }
+
+  private:
+    std::shared_ptr<json_mapped_file> file;
+    const char*                       first;
+    const char*                       last;
+};  // class json_lazy_document
+
+}  // namespace json
@@ -0,0 +1,303 @@
+#include "json_msgpack.hpp"
+
+#include <cmath>
+#include <cstring>
+
+using namespace json;
+
+// class json_msgpack_writer
+json_msgpack_writer::json_msgpack_writer(std::string& out) : out(&out) {}
+void json_msgpack_writer::put(uint8_t tag, uint64_t value, int bytes)
+{
+    char buf[9];
+    buf[0] = static_cast<char>(tag);
+    for (int i = bytes; i > 0; i--) {
+        buf[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    out->append(buf, bytes + 1);
+}
+void json_msgpack_writer::array_header(std::size_t size)
+{
+    if (size < 16) {
+        out->push_back(static_cast<char>(0x90 | size));
+    } else if (size <= 0xffff) {
+        put(0xdc, size, 2);
+    } else {
+        put(0xdd, size, 4);
+    }
+}
+void json_msgpack_writer::map_header(std::size_t size)
+{
+    if (size < 16) {
+        out->push_back(static_cast<char>(0x80 | size));
+    } else if (size <= 0xffff) {
+        put(0xde, size, 2);
+    } else {
+        put(0xdf, size, 4);
+    }
+}
+void json_msgpack_writer::string(std::string_view s)
+{
+    std::size_t size = s.size();
+    if (size < 32) {
+        out->push_back(static_cast<char>(0xa0 | size));
+    } else if (size <= 0xff) {
+        put(0xd9, size, 1);
+    } else if (size <= 0xffff) {
+        put(0xda, size, 2);
+    } else {
+        put(0xdb, size, 4);
+    }
+    out->append(s.data(), size);
+}
+void json_msgpack_writer::number(double d)
+{
+    float f = static_cast<float>(d);
+    if (static_cast<double>(f) == d || std::isnan(d)) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        put(0xca, bits, 4);
+        return;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    put(0xcb, bits, 8);
+}
+void json_msgpack_writer::number(int64_t i)
+{
+    if (i >= 0) {
+        number(static_cast<uint64_t>(i));
+    } else if (i >= -32) {
+        out->push_back(static_cast<char>(i));
+    } else if (i >= INT8_MIN) {
+        put(0xd0, static_cast<uint8_t>(i), 1);
+    } else if (i >= INT16_MIN) {
+        put(0xd1, static_cast<uint16_t>(i), 2);
+    } else if (i >= INT32_MIN) {
+        put(0xd2, static_cast<uint32_t>(i), 4);
+    } else {
+        put(0xd3, static_cast<uint64_t>(i), 8);
+    }
+}
+void json_msgpack_writer::number(uint64_t u)
+{
+    if (u < 0x80) {
+        out->push_back(static_cast<char>(u));
+    } else if (u <= UINT8_MAX) {
+        put(0xcc, u, 1);
+    } else if (u <= UINT16_MAX) {
+        put(0xcd, u, 2);
+    } else if (u <= UINT32_MAX) {
+        put(0xce, u, 4);
+    } else {
+        put(0xcf, u, 8);
+    }
+}
+void json_msgpack_writer::number(const json_number& n)
+{
+    switch (n.type) {
+        case NUMBER_INT64: number(n.i); break;
+        case NUMBER_UINT64: number(n.u); break;
+        default: number(n.d); break;
+    }
+}
+void json_msgpack_writer::boolean(bool b)
+{
+    out->push_back(static_cast<char>(b ? 0xc3 : 0xc2));
+}
+void json_msgpack_writer::null()
+{
+    out->push_back(static_cast<char>(0xc0));
+}
+void json_msgpack_writer::write(const json_value& value)
+{
+    //* 与 json_writer::write 一样用显式的栈, 不受调用栈深度限制
+    struct level {
+        const json_value* container;
+        std::size_t       next;
+    };
+    std::vector<level> stack;
+    const json_value*  current = &value;
+    while (true) {
+        const auto& v = current->json;
+        if (auto s = std::get_if<json_string>(&v)) {
+            string(*s);
+        } else if (auto d = std::get_if<double>(&v)) {
+            number(*d);
+        } else if (auto i = std::get_if<int64_t>(&v)) {
+            number(*i);
+        } else if (auto u = std::get_if<uint64_t>(&v)) {
+            number(*u);
+        } else if (auto b = std::get_if<bool>(&v)) {
+            boolean(*b);
+        } else if (std::holds_alternative<nullptr_t>(v)) {
+            null();
+        } else if (auto array = std::get_if<json_array>(&v)) {
+            array_header(array->size());
+            stack.push_back(level{current, 0});
+        } else if (auto object = std::get_if<json_object>(&v)) {
+            map_header(object->size());
+            stack.push_back(level{current, 0});
+        } else {
+            throw std::runtime_error("json to msgpack error.");
+        }
+        //* 容器的个数已经写在头部, 写完的容器直接出栈, 不用写结尾
+        current = nullptr;
+        while (current == nullptr && !stack.empty()) {
+            level& top = stack.back();
+            if (auto array = std::get_if<json_array>(&top.container->json)) {
+                if (top.next < array->size()) {
+                    current = (*array)[top.next++];
+                    continue;
+                }
+            } else {
+                auto& object = std::get<json_object>(top.container->json);
+                if (top.next < object.size()) {
+                    const auto& member = *(object.begin() + top.next++);
+                    string(member.first);
+                    current = member.second;
+                    continue;
+                }
+            }
+            stack.pop_back();
+        }
+        if (current == nullptr) {
+            return;
+        }
+    }
+}
+// class json_msgpack_writer
+
+// class json_msgpack_parser
+json_msgpack_parser::json_msgpack_parser(const char* data, std::size_t size) : p(data), end(data + size) {}
+json_msgpack_parser::json_msgpack_parser(std::string& path) : file(std::make_shared<json_mapped_file>(path))
+{
+    p   = file->data();
+    end = p + file->size();
+}
+json_document json_msgpack_parser::parse()
+{
+    //* 二进制比文本紧凑, arena 按文本的估计再放大一些
+    json_document         doc((end - p) * 2);
+    json_document_builder builder(doc);
+    parse(builder);
+    return doc;
+}
+uint64_t json_msgpack_parser::read_big_endian(int bytes)
+{
+    if (end - p < bytes) {
+        throw std::runtime_error("msgpack error : unexpected end of input.");
+    }
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value = (value << 8) | uint8_t(p[i]);
+    }
+    p += bytes;
+    return value;
+}
+std::string_view json_msgpack_parser::read_bytes(std::size_t size)
+{
+    if (std::size_t(end - p) < size) {
+        throw std::runtime_error("msgpack error : unexpected end of input.");
+    }
+    std::string_view s(p, size);
+    p += size;
+    return s;
+}
+void json_msgpack_parser::read_item(item& out)
+{
+    uint8_t tag = static_cast<uint8_t>(read_big_endian(1));
+    //* 正负 fixint
+    if (tag < 0x80 || tag >= 0xe0) {
+        out.type        = NUMBER;
+        out.number.type = NUMBER_INT64;
+        out.number.i    = static_cast<int8_t>(tag);
+        return;
+    }
+    std::size_t size = 0;
+    if (tag < 0x90) {
+        out.type = BEGIN_OBJECT;
+        size     = tag & 0x0f;
+    } else if (tag < 0xa0) {
+        out.type = BEGIN_ARRAY;
+        size     = tag & 0x0f;
+    } else if (tag < 0xc0) {
+        out.type = STRING;
+        size     = tag & 0x1f;
+    } else {
+        switch (tag) {
+            case 0xc0: out.type = NULL_VALUE; return;
+            case 0xc2:
+            case 0xc3:
+                out.type    = BOOLEAN;
+                out.boolean = tag == 0xc3;
+                return;
+            case 0xca: {
+                uint32_t bits = static_cast<uint32_t>(read_big_endian(4));
+                float    f;
+                std::memcpy(&f, &bits, sizeof(f));
+                out.type        = NUMBER;
+                out.number.type = NUMBER_DOUBLE;
+                out.number.d    = f;
+                return;
+            }
+            case 0xcb: {
+                uint64_t bits = read_big_endian(8);
+                out.type        = NUMBER;
+                out.number.type = NUMBER_DOUBLE;
+                std::memcpy(&out.number.d, &bits, sizeof(double));
+                return;
+            }
+            //* 无符号整数: 放得进 int64 的与文本解析一样按 int64 保存
+            case 0xcc:
+            case 0xcd:
+            case 0xce:
+            case 0xcf: {
+                uint64_t u = read_big_endian(1 << (tag - 0xcc));
+                out.type   = NUMBER;
+                if (u <= uint64_t(INT64_MAX)) {
+                    out.number.type = NUMBER_INT64;
+                    out.number.i    = static_cast<int64_t>(u);
+                } else {
+                    out.number.type = NUMBER_UINT64;
+                    out.number.u    = u;
+                }
+                return;
+            }
+            case 0xd0:
+            case 0xd1:
+            case 0xd2:
+            case 0xd3: {
+                int      bytes = 1 << (tag - 0xd0);
+                uint64_t u     = read_big_endian(bytes);
+                int      shift = 64 - bytes * 8;
+                out.type        = NUMBER;
+                out.number.type = NUMBER_INT64;
+                out.number.i    = static_cast<int64_t>(u << shift) >> shift;  // 符号扩展
+                return;
+            }
+            case 0xd9: out.type = STRING; size = read_big_endian(1); break;
+            case 0xda: out.type = STRING; size = read_big_endian(2); break;
+            case 0xdb: out.type = STRING; size = read_big_endian(4); break;
+            case 0xdc: out.type = BEGIN_ARRAY; size = read_big_endian(2); break;
+            case 0xdd: out.type = BEGIN_ARRAY; size = read_big_endian(4); break;
+            case 0xde: out.type = BEGIN_OBJECT; size = read_big_endian(2); break;
+            case 0xdf: out.type = BEGIN_OBJECT; size = read_big_endian(4); break;
+            default: throw std::runtime_error(fmt::format("msgpack error : unsupported type {:#04x}", int(tag)));
+        }
+    }
+    if (out.type == STRING) {
+        out.text = read_bytes(size);
+        if (!validate_utf8(out.text.data(), out.text.size())) {
+            throw std::runtime_error("Invalid UTF-8 in msgpack string");
+        }
+        return;
+    }
+    //* 每个元素至少占一个字节, 声明的个数超过剩下的字节数时输入一定被截断了
+    if (size > std::size_t(end - p)) {
+        throw std::runtime_error("msgpack error : unexpected end of input.");
+    }
+    out.size = size;
+}
+// class json_msgpack_parser
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "json_sax.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+//* MessagePack 编码: 与 to_string() 表示同一棵树, 但更紧凑, 读的时候也不用再解析文本.
+//* 整数按能放下的最小格式写出, int64/uint64 保持精确; double 能无损放进 float32 时写 float32, 否则写 float64.
+//* 对象的成员按顺序写出, 重复的键也原样保留
+class json_msgpack_writer {
+  public:
+    //* 输出追加到 out
+    explicit json_msgpack_writer(std::string& out);
+
+    //* 容器要先写出元素个数(对象是成员个数), 再依次写出元素; 对象的每个成员是一个键和一个值
+    void array_header(std::size_t size);
+    void map_header(std::size_t size);
+    void string(std::string_view s);
+    void number(double d);
+    void number(int64_t i);
+    void number(uint64_t u);
+    void number(const json_number& n);
+    void boolean(bool b);
+    void null();
+
+    //* 写出整个节点; 用显式的栈遍历, 嵌套多深都不会用完调用栈
+    void write(const json_value& value);
+
+  private:
+    //* 类型字节之后跟 bytes 个字节的大端整数
+    void put(uint8_t tag, uint64_t value, int bytes);
+
+    std::string* out;
+};  // class json_msgpack_writer
+
+//* MessagePack 解码: 与 json_parser 一样可以建树, 也可以作为 SAX 事件源.
+//* SAX 方式下字符串和键是直接指向输入的视图, 不拷贝; 容器用显式的栈, 嵌套深度不受调用栈限制.
+//* 只接受能表示成 JSON 的类型: bin、ext 和非字符串的键会抛出异常
+class json_msgpack_parser {
+  public:
+    json_msgpack_parser(const char* data, std::size_t size);
+    //* 与 json_parser(std::string&) 一样, 参数是文件路径
+    explicit json_msgpack_parser(std::string& path);
+
+    json_document parse();
+    //* handler 的接口与 json_sax_handler 相同, 任何一个回调返回 false 时停止并返回 false
+    template <class Handler> bool parse(Handler& handler);
+
+  private:
+    //* 一个值的头部: 标量整个读完, 容器只读出元素个数
+    struct item {
+        token_type       type;
+        json_number      number;
+        std::string_view text;
+        bool             boolean = false;
+        std::size_t      size    = 0;
+    };
+    void             read_item(item& out);
+    uint64_t         read_big_endian(int bytes);
+    std::string_view read_bytes(std::size_t size);
+
+    std::shared_ptr<json_mapped_file> file;
+    const char*                       p;
+    const char*                       end;
+};  // class json_msgpack_parser
+
+template <class Handler> bool json_msgpack_parser::parse(Handler& handler)
+{
+    struct level {
+        std::size_t remaining;  // 还没读的元素(成员)个数
+        bool        object;
+    };
+    std::vector<level> stack;
+    item               it;
+    do {
+        if (!stack.empty()) {
+            level& top = stack.back();
+            if (top.remaining == 0) {
+                bool object = top.object;
+                stack.pop_back();
+                if (!(object ? handler.on_end_object() : handler.on_end_array())) {
+                    return false;
+                }
+                continue;
+            }
+            top.remaining--;
+            if (top.object) {
+                read_item(it);
+                if (it.type != STRING) {
+                    throw std::runtime_error("msgpack error : map key is not a string.");
+                }
+                if (!handler.on_key(it.text)) {
+                    return false;
+                }
+            }
+        }
+        read_item(it);
+        bool go_on = true;
+        switch (it.type) {
+            case STRING: go_on = handler.on_string(it.text); break;
+            case NUMBER: go_on = handler.on_number(it.number); break;
+            case BOOLEAN: go_on = handler.on_boolean(it.boolean); break;
+            case NULL_VALUE: go_on = handler.on_null(); break;
+            case BEGIN_ARRAY:
+                stack.push_back(level{it.size, false});
+                go_on = handler.on_begin_array();
+                break;
+            default:
+                stack.push_back(level{it.size, true});
+                go_on = handler.on_begin_object();
+                break;
+        }
+        if (!go_on) {
+            return false;
+        }
+    } while (!stack.empty());
+    if (p != end) {
+        throw std::runtime_error("msgpack error : unexpected bytes after document.");
+    }
+    return true;
+}
+
+}  // namespace json
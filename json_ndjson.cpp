@@ -0,0 +1,107 @@
+#include "json_ndjson.hpp"
+
+#include <cstring>
+
+using namespace json;
+
+namespace {
+
+inline bool is_blank(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p == end;
+}
+
+}  // namespace
+
+// class json_ndjson_parser
+json_ndjson_parser::json_ndjson_parser(std::string& path, unsigned threads)
+    : file(std::make_shared<json_mapped_file>(path)), pool(threads)
+{
+    first = cur = file->data();
+    last        = first + file->size();
+}
+json_ndjson_parser::json_ndjson_parser(const char* data, std::size_t size, unsigned threads)
+    : first(data), cur(data), last(data + size), pool(threads)
+{
+}
+std::vector<json_ndjson_record> json_ndjson_parser::parse()
+{
+    std::vector<json_ndjson_record> records;
+    lines.clear();
+    split(last - cur);
+    parse_lines(records);
+    return records;
+}
+bool json_ndjson_parser::parse(const std::function<bool(json_ndjson_record&)>& callback)
+{
+    //* 每段给每个线程几批, 让窃取有余地; 段再大时一段的结果树装不进缓存, 反而变慢
+    const std::size_t               segment = batch_size * 4 * pool.size();
+    std::vector<json_ndjson_record> records;
+    while (cur < last) {
+        lines.clear();
+        records.clear();
+        split(segment);
+        parse_lines(records);
+        for (json_ndjson_record& record : records) {
+            if (!callback(record)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+void json_ndjson_parser::split(std::size_t limit)
+{
+    const char* start = cur;
+    while (cur < last && static_cast<std::size_t>(cur - start) < limit) {
+        const char* nl = static_cast<const char*>(std::memchr(cur, '\n', last - cur));
+        if (nl == nullptr) {
+            nl = last;
+        }
+        line_number++;
+        if (!is_blank(cur, nl)) {
+            lines.push_back({cur, static_cast<std::size_t>(nl - cur), line_number});
+        }
+        cur = nl < last ? nl + 1 : last;
+    }
+}
+void json_ndjson_parser::parse_lines(std::vector<json_ndjson_record>& records)
+{
+    //* 按字节数切批: 第 i 批是 lines[bounds[i], bounds[i + 1])
+    std::vector<std::size_t> bounds = {0};
+    std::size_t              bytes  = 0;
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        bytes += lines[i].size;
+        if (bytes >= batch_size) {
+            bounds.push_back(i + 1);
+            bytes = 0;
+        }
+    }
+    if (bounds.back() != lines.size()) {
+        bounds.push_back(lines.size());
+    }
+
+    std::size_t base = records.size();
+    records.resize(base + lines.size());
+    pool.run(bounds.size() - 1, [&](std::size_t batch) {
+        for (std::size_t i = bounds[batch]; i < bounds[batch + 1]; i++) {
+            const line&         l      = lines[i];
+            json_ndjson_record& record = records[base + i];
+            record.line                = l.number;
+            record.offset              = l.begin - first;
+            try {
+                json_parser parser(l.begin, l.size);
+                record.document = parser.parse();
+            } catch (const json_parse_error& e) {
+                record.error        = e.message();
+                record.error_offset = record.offset + e.offset();
+            } catch (const std::exception& e) {
+                record.error = e.what();
+            }
+        }
+    });
+}
+// class json_ndjson_parser
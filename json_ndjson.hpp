@@ -0,0 +1,67 @@
+#pragma once
+
+#include "json_parser.hpp"
+#include "json_thread_pool.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace json {
+
+//* NDJSON 中的一行: 解析成功时 document 有效, 失败时 error 是错误信息, 不影响其他行
+struct json_ndjson_record {
+    std::size_t   line         = 0;                       // 从 1 开始的行号, 空行也计数
+    std::size_t   offset       = 0;                       // 行首在输入中的字节偏移
+    std::size_t   error_offset = json_parse_error::npos;  // 出错位置在输入中的字节偏移, 不是格式错误时为 npos
+    json_document document;
+    std::string   error;
+
+    bool ok() const
+    {
+        return error.empty();
+    }
+};  // struct json_ndjson_record
+
+//* NDJSON / JSON Lines: 每行一个独立的 JSON 值. JSON 字符串里不会出现未转义的换行,
+//* 所以记录边界只需要找 '\n', 不用先解析. 行按字节数分成若干批交给线程池并行解析,
+//* 结果按输入顺序返回或回调. 只含空白的行被跳过
+class json_ndjson_parser {
+  public:
+    //* threads 为 0 时使用全部硬件线程
+    explicit json_ndjson_parser(std::string& path, unsigned threads = 0);
+    json_ndjson_parser(const char* data, std::size_t size, unsigned threads = 0);
+
+    //* 解析所有行, 结果按输入顺序排列
+    std::vector<json_ndjson_record> parse();
+    //* 分段解析, 每段解析完按输入顺序逐条回调, 内存里只保留一段的结果.
+    //* 回调返回 false 时停止, parse 返回 false
+    bool parse(const std::function<bool(json_ndjson_record&)>& callback);
+
+  private:
+    struct line {
+        const char* begin;
+        std::size_t size;
+        std::size_t number;
+    };
+
+    //* 从 cur 开始切出约 limit 字节的行追加到 lines, 输入结束时停止
+    void split(std::size_t limit);
+    //* 并行解析 lines 中的所有行, 结果追加到 records 末尾
+    void parse_lines(std::vector<json_ndjson_record>& records);
+
+    //* 一个任务解析的字节数, 太小时调度开销显著, 太大时线程之间负载不均
+    static constexpr std::size_t batch_size = 64 * 1024;
+
+    std::shared_ptr<json_mapped_file> file;
+    const char*                       first;
+    const char*                       cur;
+    const char*                       last;
+    std::size_t                       line_number = 0;  // cur 之前已经切出的行数
+    std::vector<line>                 lines;
+    json_thread_pool                  pool;
+};  // class json_ndjson_parser
+
+}  // namespace json
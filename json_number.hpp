@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+namespace json {
+
+enum number_type : uint8_t {
+    NUMBER_INT64  = 1,  // 没有小数和指数部分, 并且能放进 int64_t
+    NUMBER_UINT64 = 2,  // 没有小数和指数部分, 超出 int64_t 但能放进 uint64_t
+    NUMBER_DOUBLE = 4   // 其余情况, 以及 -0
+};
+
+//* 一个已解析的 JSON 数字, 整数保持精确值, 只有带小数/指数或超出 64 位的整数才是 double
+struct json_number {
+    number_type type = NUMBER_INT64;
+    union {
+        int64_t  i = 0;
+        uint64_t u;
+        double   d;
+    };
+
+    bool is_integer() const
+    {
+        return type != NUMBER_DOUBLE;
+    }
+    double as_double() const
+    {
+        switch (type) {
+            case NUMBER_INT64: return static_cast<double>(i);
+            case NUMBER_UINT64: return static_cast<double>(u);
+            default: return d;
+        }
+    }
+};  // struct json_number
+
+//* 按 JSON 语法解析 [p, end) 开头的数字, 结果写入 out, 返回数字之后的位置.
+//* 不分配内存, 与 locale 无关, double 按 IEEE 就近舍入得到正确结果:
+//* 先试 Clinger 快速路径, 再用 Eisel-Lemire 算法, 极少数无法判定的情况才交给 std::from_chars.
+//* 语法错误或超出 double 范围时抛出 std::runtime_error
+const char* parse_number(const char* p, const char* end, json_number& out);
+//* 语法和舍入同 parse_number, 但整数也直接得出 double, 不再区分 int64/uint64
+const char* parse_double(const char* p, const char* end, double& out);
+
+}  // namespace json
@@ -0,0 +1,157 @@
+#include "json_parallel.hpp"
+#include "json_sax.hpp"
+
+using namespace json;
+
+// class json_parallel_parser
+json_parallel_parser::json_parallel_parser(std::string& path, unsigned threads)
+    : file(std::make_shared<json_mapped_file>(path)), pool(threads)
+{
+    first = file->data();
+    last  = first + file->size();
+}
+json_parallel_parser::json_parallel_parser(const char* data, std::size_t size, unsigned threads)
+    : first(data), last(data + size), pool(threads)
+{
+}
+json_document json_parallel_parser::parse()
+{
+    std::size_t        size = last - first;
+    std::vector<chunk> chunks;
+    bool               object = false;
+    //* 每个线程分到几段, 让窃取有余地
+    if (pool.size() == 1 || size < min_parallel_size || !split(size / (pool.size() * 4), chunks, object)) {
+        json_parser parser(first, size);
+        return parser.parse();
+    }
+
+    std::vector<json_document>      parts(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    pool.run(chunks.size(), [&](std::size_t i) {
+        try {
+            parse_chunk(chunks[i], object, parts[i]);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    });
+    //* 报告输入中最靠前的错误, 与单线程解析一致
+    for (std::exception_ptr& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    json_document doc;
+    json_arena&   arena = *doc.arena;
+    if (object) {
+        doc.root_value = arena.create<json_value>(json_object(&arena));
+        for (json_document& part : parts) {
+            for (auto& member : part.root_value->get_object()) {
+                doc.root_value->put_value(member.first, member.second);
+            }
+        }
+    } else {
+        std::size_t total = 0;
+        for (json_document& part : parts) {
+            total += part.root_value->get_array().size();
+        }
+        json_array elements(&arena);
+        elements.reserve(total);
+        for (json_document& part : parts) {
+            json_array& array = part.root_value->get_array();
+            elements.insert(elements.end(), array.begin(), array.end());
+        }
+        doc.root_value = arena.create<json_value>(std::move(elements));
+    }
+    for (json_document& part : parts) {
+        doc.parts.push_back(std::move(part.arena));
+    }
+    return doc;
+}
+bool json_parallel_parser::split(std::size_t target, std::vector<chunk>& chunks, bool& object)
+{
+    json_structural_scanner     scanner;
+    std::unique_ptr<uint32_t[]> structurals(new uint32_t[window_size + json_structural_scanner::padding]);
+    const char*                 begin = nullptr;  // 当前段的起点
+    const char*                 close = nullptr;  // 顶层容器的结束符
+    long                        depth = 0;
+    for (const char* window = first; window < last; window += window_size) {
+        std::size_t n     = std::min<std::size_t>(window_size, last - window);
+        std::size_t count = scanner.scan(window, n, structurals.get());
+        for (std::size_t i = 0; i < count; i++) {
+            const char* p = window + structurals[i];
+            if (close != nullptr) {
+                return false;  // 顶层值之后还有内容
+            }
+            switch (*p) {
+                case '[':
+                case '{':
+                    if (depth++ == 0) {
+                        object = *p == '{';
+                        begin  = p + 1;
+                    }
+                    break;
+                case ']':
+                case '}':
+                    if (--depth == 0) {
+                        close = p;
+                    } else if (depth < 0) {
+                        return false;
+                    }
+                    break;
+                case ',':
+                    if (depth == 1 && static_cast<std::size_t>(p - begin) >= target) {
+                        chunks.push_back({begin, p});
+                        begin = p + 1;
+                    }
+                    break;
+                default:
+                    if (depth == 0) {
+                        return false;  // 顶层是标量
+                    }
+                    break;
+            }
+        }
+    }
+    scanner.finish();
+    if (close == nullptr || scanner.in_string() || (*close == '}') != object) {
+        return false;
+    }
+    chunks.push_back({begin, close});
+    return chunks.size() > 1;
+}
+void json_parallel_parser::parse_chunk(const chunk& c, bool object, json_document& part) const
+{
+    json_document_builder builder(part);
+    json_grammar          grammar;
+    if (object) {
+        grammar.begin_object();
+        builder.on_begin_object();
+    } else {
+        grammar.begin_array();
+        builder.on_begin_array();
+    }
+    json_parser parser(c.begin, c.end - c.begin);
+    try {
+        parser.parse(builder, grammar);
+    } catch (const json_parse_error& e) {
+        //* 段内的位置换算成整个输入中的位置
+        throw e.at(e.offset() + (c.begin - first));
+    }
+    //* 段在顶层的逗号或容器结尾处截止, 下面的错误都报在这个字符上, 与单线程解析相同.
+    //* 段内最后一个元素必须完整; 空段说明原文在这里有两个相邻的逗号, 或者最后一个元素之后多了逗号
+    try {
+        if (object) {
+            grammar.end_object();
+        } else {
+            grammar.end_array();
+        }
+        grammar.end_document();
+        if (object ? part.root_value->get_object().empty() : part.root_value->get_array().empty()) {
+            json_grammar::unexpected(*c.end == ',' ? SEP_COMMA : object ? END_OBJECT : END_ARRAY);
+        }
+    } catch (const json_parse_error& e) {
+        throw e.at(c.end - first);
+    }
+}
+// class json_parallel_parser
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "json_parser.hpp"
+#include "json_thread_pool.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace json {
+
+//* 单个大文档的并行解析: 先用 stage 1 扫一遍, 在顶层数组(或对象)深度为 1 的逗号处把元素切成大小相近的若干段,
+//* 每段在线程池里各自建成一棵子树, 最后把各段的元素按顺序挂到同一个根节点上. 子树留在各自的 arena 里,
+//* 由文档统一持有, 不做拷贝. 顶层不是容器、输入太小或者预扫描发现格式错误时退回单线程解析,
+//* 错误信息与 json_parser 一致
+class json_parallel_parser {
+  public:
+    //* threads 为 0 时使用全部硬件线程
+    explicit json_parallel_parser(std::string& path, unsigned threads = 0);
+    json_parallel_parser(const char* data, std::size_t size, unsigned threads = 0);
+
+    json_document parse();
+
+  private:
+    struct chunk {
+        const char* begin;
+        const char* end;
+    };
+
+    //* 预扫描并切段, 每段至少 target 字节. 只切出一段或者需要单线程解析来报错时返回 false
+    bool split(std::size_t target, std::vector<chunk>& chunks, bool& object);
+    //* 把一段元素解析成 part 的根容器. 抛出的 json_parse_error 的位置从整个输入的开头算起
+    void parse_chunk(const chunk& c, bool object, json_document& part) const;
+
+    //* 小于这个大小的输入直接单线程解析
+    static constexpr std::size_t min_parallel_size = 1024 * 1024;
+    //* 预扫描的窗口, 索引只覆盖当前窗口
+    static constexpr std::size_t window_size = 64 * 1024;
+
+    std::shared_ptr<json_mapped_file> file;
+    const char*                       first;
+    const char*                       last;
+    json_thread_pool                  pool;
+};  // class json_parallel_parser
+
+}  // namespace json
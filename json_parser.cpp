@@ -1,44 +1,225 @@
 #include "json_parser.hpp"
+#include "json_intern.hpp"
+#include "json_sax.hpp"
+#include "json_writer.hpp"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define JSON_HAS_MMAP 1
+#endif
 
 using namespace json;
 
+// class json_parse_error
+json_parse_error::json_parse_error(const std::string& message, std::size_t offset)
+    : std::runtime_error(offset == npos ? message : fmt::format("{} (at offset {})", message, offset)), text(message), position(offset)
+{
+}
+// class json_parse_error
+
 // class json_node
 // class json_node
 
-// class json_char_reader
-json_char_reader::json_char_reader(std::string& str) : in(str) {}
-char json_char_reader::get()
+// class json_mapped_file
+#ifdef JSON_HAS_MMAP
+json_mapped_file::json_mapped_file(const std::string& path, bool sequential)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("json open file error : {}", path));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error(fmt::format("json stat file error : {}", path));
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    if (length > 0) {
+        void* p = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error(fmt::format("json mmap file error : {}", path));
+        }
+        if (sequential) {
+            ::madvise(p, length, MADV_SEQUENTIAL);
+        }
+        addr = static_cast<const char*>(p);
+    }
+    ::close(fd);
+}
+json_mapped_file::~json_mapped_file()
 {
-    return in.get();
+    if (addr != nullptr && contents.empty()) {
+        ::munmap(const_cast<char*>(addr), length);
+    }
 }
-char json_char_reader::peek()
+void json_mapped_file::release(std::size_t offset)
 {
-    return in.peek();
+    static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t              upto = offset / page * page;
+    if (addr == nullptr || upto <= released) {
+        return;
+    }
+    //* 只读的私有映射从未被写过, 丢弃的页之后访问时会从文件重新读入, 已经交出去的视图仍然有效
+    ::madvise(const_cast<char*>(addr) + released, upto - released, MADV_DONTNEED);
+    released = upto;
 }
-std::string json_char_reader::next(int cnt)
+#else
+json_mapped_file::json_mapped_file(const std::string& path, bool)
 {
-    std::string s;
-    while (cnt--) {
-        s.push_back(in.get());
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error(fmt::format("json open file error : {}", path));
     }
-    return s;
+    contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    addr   = contents.data();
+    length = contents.size();
 }
-bool json_char_reader::has_more()
+json_mapped_file::~json_mapped_file() {}
+void json_mapped_file::release(std::size_t) {}
+#endif
+// class json_mapped_file
+
+// class json_char_reader
+json_char_reader::json_char_reader(std::string& str) : file(std::make_shared<json_mapped_file>(str))
 {
-    return !in.eof();
+    first = file->data();
+    cur   = first;
+    last  = first + file->size();
 }
+json_char_reader::json_char_reader(const char* data, std::size_t size) : first(data), cur(data), last(data + size) {}
 // class json_char_reader
 
 // class json_token_reader
-json_token_reader::json_token_reader(std::string& str) : char_reader(str) {}
+const char* json::find_invalid_utf8(const char* p, const char* end)
+{
+    while (p < end) {
+        uint8_t c = *p;
+        if (c < 0x80) {
+            p++;
+            continue;
+        }
+        int      n;
+        uint32_t min;
+        if ((c & 0xe0) == 0xc0) {
+            n = 2, min = 0x80;
+        } else if ((c & 0xf0) == 0xe0) {
+            n = 3, min = 0x800;
+        } else if ((c & 0xf8) == 0xf0) {
+            n = 4, min = 0x10000;
+        } else {
+            return p;
+        }
+        if (end - p < n) {
+            return p;
+        }
+        uint32_t cp = c & (0x7f >> n);
+        for (int i = 1; i < n; i++) {
+            if ((p[i] & 0xc0) != 0x80) {
+                return p;
+            }
+            cp = (cp << 6) | (p[i] & 0x3f);
+        }
+        //* 过长编码、代理项和超出 U+10FFFF 的码点
+        if (cp < min || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff)) {
+            return p;
+        }
+        p += n;
+    }
+    return end;
+}
+json_token_reader::json_token_reader(std::string& str)
+    : char_reader(str), structurals(new uint32_t[index_capacity()]), structural_capacity(index_capacity())
+{
+    scanned = window = char_reader.position();
+}
+json_token_reader::json_token_reader(const char* data, std::size_t size)
+    : char_reader(data, size), structurals(new uint32_t[index_capacity()]), structural_capacity(index_capacity())
+{
+    scanned = window = char_reader.position();
+}
+void json_token_reader::reset(const char* data, std::size_t size)
+{
+    char_reader.reset(data, size);
+    scanner.reset();
+    if (index_capacity() > structural_capacity) {
+        structural_capacity = index_capacity();
+        structurals.reset(new uint32_t[structural_capacity]);
+    }
+    structural_count = 0;
+    structural_pos   = 0;
+    scanned = window = char_reader.position();
+}
+void json_token_reader::scan_window()
+{
+    char_reader.release_consumed();
+    window           = scanned;
+    std::size_t n    = std::min<std::size_t>(window_size, char_reader.end() - window);
+    JSON_STATS(auto start = std::chrono::steady_clock::now());
+    structural_count = scanner.scan(window, n, structurals.get());
+    structural_pos   = 0;
+    scanned          = window + n;
+    if (scanned == char_reader.end()) {
+        scanner.finish();
+    }
+    if (!scanner.utf8_valid()) {
+        //* 非法序列可能从上一个窗口的最后几个字节开始, 退回到那个字符的开头再逐个检查
+        const char* p = window;
+        for (int i = 0; i < 3 && p > char_reader.begin() && (uint8_t(*p) & 0xc0) == 0x80; i++) {
+            p--;
+        }
+        fail(find_invalid_utf8(p, scanned), "Invalid UTF-8 in json input");
+    }
+    JSON_STATS({
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        parse_stats.windows++;
+        parse_stats.scanned_bytes += n;
+        parse_stats.structurals += structural_count;
+        parse_stats.stage1_ns += ns;
+        emit(TRACE_WINDOW, window - char_reader.begin(), n, ns);
+    })
+}
+void json_token_reader::check_delimiter()
+{
+    if (!char_reader.has_more()) {
+        return;
+    }
+    switch (char_reader.peek()) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case ',':
+        case ':':
+        case ']':
+        case '}':
+        case '[':
+        case '{':
+        case '"': return;
+        default: fail(char_reader.position(), fmt::format("Unexpected json char : {}", char_reader.peek()));
+    }
+}
+void json_token_reader::fail(const char* at, const std::string& message) const
+{
+    throw json_parse_error(message, at - char_reader.begin());
+}
 token_type json_token_reader::next_token()
 {
-    token_type token;
-    char       c = char_reader.peek();
-    if (c == -1) {
+    token_type  token;
+    const char* p = next_structural();
+    if (p == nullptr) {
+        char_reader.seek(char_reader.end());
         token = END_DOCUMENT;
+        JSON_STATS(parse_stats.tokens[json_parse_stats::token_index(token)]++);
         return token;
     }
+    char_reader.seek(p);
+    char c = *p;
     switch (c) {
         case '{': token = BEGIN_OBJECT; break;
         case '}': token = END_OBJECT; break;
@@ -61,59 +242,189 @@ token_type json_token_reader::next_token()
         case '7':
         case '8':
         case '9': token = NUMBER; break;
-        case ' ':
-        case '\n':
-        case '\r': token = BLANK; break;
-        default:
-            printf("%i\n", c);
-            throw std::runtime_error(fmt::format("Unexpected json char : {}", c));
-            break;
+        default: fail(p, fmt::format("Unexpected json char : {}", c));
     }
+    JSON_STATS(parse_stats.tokens[json_parse_stats::token_index(token)]++);
     return token;
 }
 bool json_token_reader::read_boolean()
 {
-    bool ret;
-    char c = char_reader.peek();
-    switch (c) {
-        case 't':
-            ret = true;
-            char_reader.next(4);
-            break;
-        case 'f':
-            ret = false;
-            char_reader.next(5);
-            break;
+    const char* start = char_reader.position();
+    char        c     = char_reader.peek();
+    if (c == 't' && char_reader.next(4) == "true") {
+        check_delimiter();
+        return true;
     }
-    return ret;
+    if (c == 'f' && char_reader.next(5) == "false") {
+        check_delimiter();
+        return false;
+    }
+    fail(start, "Invalid boolean");
 }
-double json_token_reader::read_number()
+json_number json_token_reader::read_number()
 {
-    double      ret;
-    bool        neg = false;
-    std::string s;
-    if (char_reader.peek() == '-') {
-        char_reader.get();
-        neg = true;
+    json_number n;
+    const char* start = char_reader.position();
+    try {
+        char_reader.seek(parse_number(start, char_reader.end(), n));
+    } catch (const std::runtime_error& e) {
+        fail(start, e.what());
     }
-    while (isdigit(char_reader.peek())) {
-        s.push_back(char_reader.get());
-    }
-    if (s.empty()) {
-        throw std::runtime_error("Invalid number");
+    check_delimiter();
+    return n;
+}
+double json_token_reader::read_double()
+{
+    double      d;
+    const char* start = char_reader.position();
+    try {
+        char_reader.seek(parse_double(start, char_reader.end(), d));
+    } catch (const std::runtime_error& e) {
+        fail(start, e.what());
     }
-    ret = std::stod(s) * (neg ? -1 : 1);
-    return ret;
+    check_delimiter();
+    return d;
 }
-std::string json_token_reader::read_string()
+std::string_view json_token_reader::read_string()
 {
-    std::string ret;
     char_reader.get();  // skip '"'
-    while (char_reader.peek() != '"') {
-        ret.push_back(char_reader.get());
+    const char* begin = char_reader.position();
+    const char* end   = char_reader.end();
+    const char* p     = find_string_special(begin, end);
+    if (p < end && *p == '"') {
+        char_reader.seek(p + 1);
+        JSON_STATS(parse_stats.string_bytes += p - begin);
+        return std::string_view(begin, p - begin);
     }
+    //* 有转义: 干净的片段整段拷贝, 转义序列逐个解码
+    scratch.assign(begin, p);
+    while (true) {
+        if (p == end) {
+            fail(begin - 1, "Unterminated string");
+        }
+        if (*p == '"') {
+            break;
+        }
+        if (*p != '\\') {
+            fail(p, fmt::format("Unescaped control character in string : {:#04x}", int(uint8_t(*p))));
+        }
+        try {
+            p = decode_escape(p, end, scratch);
+        } catch (const json_parse_error& e) {
+            fail(p, e.message());
+        }
+        const char* run = find_string_special(p, end);
+        scratch.append(p, run);
+        p = run;
+    }
+    char_reader.seek(p + 1);
+    JSON_STATS(parse_stats.string_bytes += p - begin; parse_stats.escaped_strings++);
+    return scratch;
+}
+std::string_view json_token_reader::read_raw_string()
+{
     char_reader.get();  // skip '"'
-    return ret;
+    const char* begin = char_reader.position();
+    const char* end   = char_reader.end();
+    const char* p     = find_string_special(begin, end);
+    while (p < end && *p != '"') {
+        if (*p != '\\') {
+            fail(p, fmt::format("Unescaped control character in string : {:#04x}", int(uint8_t(*p))));
+        }
+        //* 输入以反斜杠结尾时不能再往后跳
+        if (end - p < 2) {
+            fail(begin - 1, "Unterminated string");
+        }
+        p = find_string_special(p + 2, end);
+    }
+    if (p >= end) {
+        fail(begin - 1, "Unterminated string");
+    }
+    char_reader.seek(p + 1);
+    JSON_STATS(parse_stats.string_bytes += p - begin);
+    return std::string_view(begin, p - begin);
+}
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+static uint32_t read_hex4(const char* p, const char* end)
+{
+    if (end - p < 4) {
+        throw json_parse_error("Invalid unicode escape");
+    }
+    uint32_t v = 0;
+    for (int i = 0; i < 4; i++) {
+        int h = hex_value(p[i]);
+        if (h < 0) {
+            throw json_parse_error("Invalid unicode escape");
+        }
+        v = (v << 4) | h;
+    }
+    return v;
+}
+const char* json::decode_escape(const char* p, const char* end, std::string& out)
+{
+    if (p + 1 >= end) {
+        throw json_parse_error("Unterminated string");
+    }
+    switch (p[1]) {
+        case '"': out.push_back('"'); return p + 2;
+        case '\\': out.push_back('\\'); return p + 2;
+        case '/': out.push_back('/'); return p + 2;
+        case 'b': out.push_back('\b'); return p + 2;
+        case 'f': out.push_back('\f'); return p + 2;
+        case 'n': out.push_back('\n'); return p + 2;
+        case 'r': out.push_back('\r'); return p + 2;
+        case 't': out.push_back('\t'); return p + 2;
+        case 'u': break;
+        default: throw json_parse_error(fmt::format("Invalid escape : \\{}", p[1]));
+    }
+    uint32_t cp = read_hex4(p + 2, end);
+    p += 6;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        //* 高代理项必须紧跟一个 \\u 低代理项
+        if (end - p < 6 || p[0] != '\\' || p[1] != 'u') {
+            throw json_parse_error("Unpaired surrogate in unicode escape");
+        }
+        uint32_t low = read_hex4(p + 2, end);
+        if (low < 0xDC00 || low > 0xDFFF) {
+            throw json_parse_error("Unpaired surrogate in unicode escape");
+        }
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        p += 6;
+    }
+    else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        throw json_parse_error("Unpaired surrogate in unicode escape");
+    }
+    if (cp < 0x80) {
+        out.push_back(char(cp));
+    }
+    else if (cp < 0x800) {
+        out.push_back(char(0xC0 | (cp >> 6)));
+        out.push_back(char(0x80 | (cp & 0x3F)));
+    }
+    else if (cp < 0x10000) {
+        out.push_back(char(0xE0 | (cp >> 12)));
+        out.push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(char(0x80 | (cp & 0x3F)));
+    }
+    else {
+        out.push_back(char(0xF0 | (cp >> 18)));
+        out.push_back(char(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(char(0x80 | (cp & 0x3F)));
+    }
+    return p;
 }
 void json_token_reader::pass_char()
 {
@@ -121,366 +432,519 @@ void json_token_reader::pass_char()
 }
 void json_token_reader::read_null()
 {
-    char_reader.next(4);
+    const char* start = char_reader.position();
+    if (char_reader.next(4) != "null") {
+        fail(start, "Invalid null");
+    }
+    check_delimiter();
 }
 // class json_token_reader
 
+// class json_arena
+json_arena::json_arena(std::size_t size_hint)
+    : first_chunk(std::clamp(size_hint + sizeof(chunk), small_chunk_size, min_chunk_size))
+{
+}
+json_arena::~json_arena()
+{
+    release();
+}
+void json_arena::reset()
+{
+    if (head == nullptr) {
+        return;
+    }
+    //* 最新的块最大, 只留下它
+    while (head->prev != nullptr) {
+        chunk* prev = head->prev->prev;
+        ::operator delete(head->prev);
+        head->prev = prev;
+    }
+    cur      = reinterpret_cast<char*>(head) + sizeof(chunk);
+    limit    = reinterpret_cast<char*>(head) + head->size;
+    used     = 0;
+    reserved = head->size;
+}
+void json_arena::release()
+{
+    while (head != nullptr) {
+        chunk* prev = head->prev;
+        ::operator delete(head);
+        head = prev;
+    }
+    cur      = nullptr;
+    limit    = nullptr;
+    used     = 0;
+    reserved = 0;
+}
+void* json_arena::grow(std::size_t bytes, std::size_t align)
+{
+    //* 新块至少翻倍, 让块的数量随文档大小对数增长
+    std::size_t size = std::max({first_chunk, reserved, bytes + align + sizeof(chunk)});
+    chunk*      c    = static_cast<chunk*>(::operator new(size));
+    c->prev          = head;
+    c->size          = size;
+    head             = c;
+    cur              = reinterpret_cast<char*>(c) + sizeof(chunk);
+    limit            = reinterpret_cast<char*>(c) + size;
+    reserved += size;
+    return do_allocate(bytes, align);
+}
+// class json_arena
+
+// class json_object
+bool json_object::insert(std::string_view key, json_value* value, duplicate_key_policy policy)
+{
+    if (policy != DUPLICATE_KEY_KEEP) {
+        std::size_t i = lookup(key);
+        if (i != npos) {
+            switch (policy) {
+                case DUPLICATE_KEY_LAST: members[i].second = value; break;
+                case DUPLICATE_KEY_ERROR: throw json_parse_error(fmt::format("Duplicate key : {}", key));
+                default: break;
+            }
+            return false;
+        }
+    }
+    //* 混入了未驻留的键, 之后只能按内容比较. 驻留键的哈希就是 std::hash, 索引不用重建
+    keys = nullptr;
+    std::pmr::memory_resource* mr    = members.get_allocator().resource();
+    char*                      bytes = static_cast<char*>(mr->allocate(key.size(), 1));
+    std::memcpy(bytes, key.data(), key.size());
+    append(std::string_view(bytes, key.size()), value);
+    return true;
+}
+bool json_object::insert(json_key key, json_value* value, duplicate_key_policy policy)
+{
+    if (members.empty()) {
+        keys = key.table();
+    }
+    if (policy != DUPLICATE_KEY_KEEP) {
+        std::size_t i = lookup(key);
+        if (i != npos) {
+            switch (policy) {
+                case DUPLICATE_KEY_LAST: members[i].second = value; break;
+                case DUPLICATE_KEY_ERROR: throw json_parse_error(fmt::format("Duplicate key : {}", key.str()));
+                default: break;
+            }
+            return false;
+        }
+    }
+    if (keys != key.table()) {
+        keys = nullptr;
+    }
+    append(key.str(), value);
+    return true;
+}
+void json_object::append(std::string_view key, json_value* value)
+{
+    members.emplace_back(key, value);
+    if (index_mask != 0) {
+        if (members.size() * 2 > std::size_t(index_mask) + 1) {
+            build_index();
+        } else {
+            index_insert(static_cast<uint32_t>(members.size() - 1));
+        }
+    }
+}
+json_value* json_object::find(std::string_view key) const
+{
+    std::size_t i = lookup(key);
+    return i == npos ? nullptr : members[i].second;
+}
+json_value* json_object::find(json_key key) const
+{
+    std::size_t i = lookup(key);
+    return i == npos ? nullptr : members[i].second;
+}
+std::size_t json_object::lookup(std::string_view key) const
+{
+    if (index_mask == 0) {
+        if (members.size() <= index_threshold) {
+            for (std::size_t i = 0; i < members.size(); i++) {
+                if (members[i].first == key) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+        build_index();
+    }
+    for (std::size_t h = std::hash<std::string_view>()(key) & index_mask;; h = (h + 1) & index_mask) {
+        uint32_t slot = index[h];
+        if (slot == 0) {
+            return npos;
+        }
+        if (members[slot - 1].first == key) {
+            return slot - 1;
+        }
+    }
+}
+std::size_t json_object::lookup(json_key key) const
+{
+    if (keys == nullptr || keys != key.table()) {
+        return lookup(key.str());
+    }
+    //* 同一个表里的键内容相同当且仅当条目相同, 比较字节的地址就够了
+    const char* data = key.str().data();
+    if (index_mask == 0) {
+        if (members.size() <= index_threshold) {
+            for (std::size_t i = 0; i < members.size(); i++) {
+                if (members[i].first.data() == data) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+        build_index();
+    }
+    for (std::size_t h = key.hash() & index_mask;; h = (h + 1) & index_mask) {
+        uint32_t slot = index[h];
+        if (slot == 0) {
+            return npos;
+        }
+        if (members[slot - 1].first.data() == data) {
+            return slot - 1;
+        }
+    }
+}
+void json_object::build_index() const
+{
+    std::pmr::memory_resource* mr   = members.get_allocator().resource();
+    std::size_t                size = 32;
+    while (size < members.size() * 2) {
+        size *= 2;
+    }
+    if (index != nullptr) {
+        mr->deallocate(index, (std::size_t(index_mask) + 1) * sizeof(uint32_t), alignof(uint32_t));
+    }
+    index      = static_cast<uint32_t*>(mr->allocate(size * sizeof(uint32_t), alignof(uint32_t)));
+    index_mask = static_cast<uint32_t>(size - 1);
+    std::memset(index, 0, size * sizeof(uint32_t));
+    for (std::size_t i = 0; i < members.size(); i++) {
+        index_insert(static_cast<uint32_t>(i));
+    }
+}
+void json_object::index_insert(uint32_t i) const
+{
+    std::string_view key = members[i].first;
+    for (std::size_t h = hash_of(key) & index_mask;; h = (h + 1) & index_mask) {
+        if (index[h] == 0) {
+            index[h] = i + 1;
+            return;
+        }
+        //* DUPLICATE_KEY_KEEP 留下的重复键只索引第一个
+        if (members[index[h] - 1].first == key) {
+            return;
+        }
+    }
+}
+// class json_object
+
 std::ostream& operator<<(std::ostream& os, json_value& jv)
 {
     os << jv.to_string();
     return os;
 }
 
-
-auto json_value::get() const
+json_value::json_value(const json_number& n)
 {
-    return json;
+    switch (n.type) {
+        case NUMBER_INT64: json = n.i; break;
+        case NUMBER_UINT64: json = n.u; break;
+        default: json = n.d; break;
+    }
 }
 std::string json_value::get_string() const
 {
-    return std::get<std::string>(json);
+    return std::string(std::get<json_string>(json));
+}
+std::string_view json_value::get_string_view() const
+{
+    return std::get<json_string>(json);
 }
 double json_value::get_number() const
 {
+    if (has_type<int64_t>()) {
+        return static_cast<double>(std::get<int64_t>(json));
+    }
+    if (has_type<uint64_t>()) {
+        return static_cast<double>(std::get<uint64_t>(json));
+    }
     return std::get<double>(json);
 }
+int64_t json_value::get_int64() const
+{
+    if (has_type<int64_t>()) {
+        return std::get<int64_t>(json);
+    }
+    throw std::runtime_error("json access number error : not an int64.");
+}
+uint64_t json_value::get_uint64() const
+{
+    if (has_type<uint64_t>()) {
+        return std::get<uint64_t>(json);
+    }
+    if (has_type<int64_t>() && std::get<int64_t>(json) >= 0) {
+        return static_cast<uint64_t>(std::get<int64_t>(json));
+    }
+    throw std::runtime_error("json access number error : not an uint64.");
+}
+bool json_value::is_integer() const
+{
+    return has_type<int64_t>() || has_type<uint64_t>();
+}
 bool json_value::get_boolean() const
 {
     return std::get<bool>(json);
 }
-std::vector<std::shared_ptr<json_node>>& json_value::get_array ()
+json_array& json_value::get_array()
 {
-    return std::get<std::vector<std::shared_ptr<json_node>>>(json);
+    return std::get<json_array>(json);
 }
-std::unordered_map<std::string, std::shared_ptr<json_node>>& json_value::get_object ()
+const json_array& json_value::get_array() const
 {
-    return std::get<std::unordered_map<std::string, std::shared_ptr<json_node>>>(json);
+    return std::get<json_array>(json);
 }
-template <class T> void json_value::set(T value)
+json_object& json_value::get_object()
 {
-    json = value;
+    return std::get<json_object>(json);
 }
-// void set(double value){
-//     json = value;
-// }
-void json_value::put_value(std::string key, json_value value)
+const json_object& json_value::get_object() const
 {
-    std::get<std::unordered_map<std::string, std::shared_ptr<json_node>>>(json)[key] = std::make_shared<json_value>(value);
+    return std::get<json_object>(json);
 }
-void json_value::push_array(json_value value)
+void json_value::put_value(std::string_view key, json_value* value, duplicate_key_policy policy)
 {
-    // std::cout << "push array" << std::endl;
-    // if (value.has_type<double>()) {
-    //     std::cout << "push array number: " << value.get_number() << std::endl;
-    // }
-    std::get<std::vector<std::shared_ptr<json_node>>>(json).push_back(std::make_shared<json_value>(value));
+    std::get<json_object>(json).insert(key, value, policy);
 }
-
-template <class T> bool json_value::has_type()
+void json_value::put_value(json_key key, json_value* value, duplicate_key_policy policy)
+{
+    std::get<json_object>(json).insert(key, value, policy);
+}
+void json_value::push_array(json_value* value)
 {
-    return std::holds_alternative<T>(json);
+    std::get<json_array>(json).push_back(value);
 }
 
 //* 访问json
 
-json_value& json_value::operator[](std::string key)
+json_value& json_value::operator[](std::string_view key)
 {
-    if (has_type<std::unordered_map<std::string, std::shared_ptr<json_node>>>()) {
-        std::unordered_map<std::string, std::shared_ptr<json_node>>& object = std::get<std::unordered_map<std::string, std::shared_ptr<json_node>>>(json);
-        if (object.count(key) == 0) {
+    if (has_type<json_object>()) {
+        json_value* value = std::get<json_object>(json).find(key);
+        if (value == nullptr) {
             throw std::runtime_error("json access object error : key not found");
         }
-        return *(std::static_pointer_cast<json_value>(object[key]));
+        return *value;
+    }
+    throw std::runtime_error("json access object error.");
+}
+json_value& json_value::operator[](json_key key)
+{
+    if (has_type<json_object>()) {
+        json_value* value = std::get<json_object>(json).find(key);
+        if (value == nullptr) {
+            throw std::runtime_error("json access object error : key not found");
+        }
+        return *value;
     }
     throw std::runtime_error("json access object error.");
 }
 json_value& json_value::operator[](std::size_t index)
 {
-    if (has_type<std::vector<std::shared_ptr<json_node>>>()) {
-        std::vector<std::shared_ptr<json_node>>& array = std::get<std::vector<std::shared_ptr<json_node>>>(json);
-        if (index < 0 || index >= array.size()) {
+    if (has_type<json_array>()) {
+        json_array& array = std::get<json_array>(json);
+        if (index >= array.size()) {
             throw std::runtime_error("json access array error : index out of range");
         }
-        return *std::static_pointer_cast<json_value>(std::get<std::vector<std::shared_ptr<json_node>>>(json)[index]);
+        return *array[index];
     }
     throw std::runtime_error("json access arrary error.");
 }
 
-std::string json_value::to_string()
+std::string json_value::to_string(int indent) const
 {
-    // std::cout << "enter to string entry\n";
     std::string ret;
-    if (has_type<std::string>()) {
-        ret.push_back('"');
-        ret.append(get_string());
-        ret.push_back('"');
-        return ret;
-    }
-    if (has_type<double>()) {
-        // std::cout << "enter number to string\n";
-        ret = std::to_string(get_number());
-        return ret;
-    }
-    if (has_type<bool>()) {
-        return get_boolean() ? "true" : "false";
-    }
-    if (has_type<std::vector<std::shared_ptr<json_node>>>()) {
-        // std::cout << "enter array to string\n";
-        ret.push_back('[');
-        // std::cout << "enter array to string push [\n";
-        for (auto v : get_array()) {
-            // if (std::static_pointer_cast<json_value>(v)->has_type<double>()) {
-            //     std::cout << "double member\n";
-            // }
-            // std::cout << "array member:\n" << std::static_pointer_cast<json_value>(v)->to_string() << std::endl;
-            ret.append(std::static_pointer_cast<json_value>(v)->to_string());
-            ret.push_back(',');
-        }
-        if (ret.back() == ',') {
-            ret.pop_back();
-        }
-        // std::cout << "enter array to string push ]\n";
-        ret.push_back(']');
-        return ret;
-    }
-    if (has_type<std::unordered_map<std::string, std::shared_ptr<json_node>>>()) {
-        ret.push_back('{');
-        for (auto& v : get_object()) {
-            ret.push_back('"');
-            ret.append(v.first);
-            ret.push_back('"');
-            ret.push_back(':');
-            ret.append(std::static_pointer_cast<json_value>(v.second)->to_string());
-            ret.push_back(',');
-        }
-        if (ret.back() == ',') {
-            ret.pop_back();
-        }
-        ret.push_back('}');
-        return ret;
-    }
-    if (has_type<nullptr_t>()) {
-        return "null";
+    {
+        json_writer writer(ret, indent);
+        writer.write(*this);
     }
+    return ret;
+}
 
-    throw std::runtime_error("json to string error.");
+// class json_document
+json_document::json_document() : arena(std::make_unique<json_arena>()) {}
+//* 节点比它对应的文本大得多(典型记录约 10 倍), 按输入的 16 倍估计; 超过一块的大小时与默认构造没有区别
+json_document::json_document(std::size_t input_size) : arena(std::make_unique<json_arena>(input_size * 16)) {}
+json_value& json_document::root()
+{
+    if (root_value == nullptr) {
+        throw std::runtime_error("json document is empty.");
+    }
+    return *root_value;
+}
+json_arena& json_document::get_arena()
+{
+    return *arena;
+}
+void json_document::clear()
+{
+    arena->reset();
+    parts.clear();
+    root_value = nullptr;
+}
+json_value& json_document::operator[](std::string_view key)
+{
+    return root()[key];
+}
+json_value& json_document::operator[](json_key key)
+{
+    return root()[key];
 }
+json_value& json_document::operator[](std::size_t index)
+{
+    return root()[index];
+}
+std::string json_document::to_string(int indent)
+{
+    return root().to_string(indent);
+}
+// class json_document
 
 // class json {};
 
-json_parser::json_parser(std::string& str) : token_reader(str) {}
-json_value json_parser::parse()
+json_parser::json_parser() : token_reader(nullptr, 0), max_depth(json_grammar::default_max_depth) {}
+json_parser::json_parser(std::string& str) : token_reader(str), max_depth(json_grammar::default_max_depth) {}
+json_parser::json_parser(const char* data, std::size_t size) : token_reader(data, size), max_depth(json_grammar::default_max_depth) {}
+json_parser::~json_parser() = default;
+json_parser::json_parser(json_parser&&) noexcept = default;
+json_parser& json_parser::operator=(json_parser&&) noexcept = default;
+void json_parser::reset(const char* data, std::size_t size)
 {
-    std::stack<json_value> json_stack;
-    uint16_t               expect    = EXPECT_SINGLE_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
-    // int                    token_cnt = 0;
-    while (true) {
-        token_type token = token_reader.next_token();
-        // std::cout << fmt::format("token {} : {}\n", token_cnt++, token);
-        switch (token) {
-            case BLANK: {
-                token_reader.pass_char();
-                continue;
-            }
-            case NUMBER: {
-                if (expect & EXPECT_SINGLE_VALUE) {
-                    json_value json(token_reader.read_number());
-                    json_stack.push(json);
-                    expect = EXPECT_END_DOCUMENT;
-                    continue;
-                }
-                if (expect & EXPECT_ARRAY_VALUE) {
-                    json_stack.top().push_array(json_value(token_reader.read_number()));
-                    // std::cout<<"json array test:"<<json_stack.top().to_string()<<std::endl;
-                    expect = EXPECT_END_ARRAY | EXPECT_COMMA;
-                    continue;
-                }
-                if (expect & EXPECT_OBJECT_VALUE) {
-                    std::string s = json_stack.top().get_string();
-                    // std::cout << "json object key:" << s << std::endl;
-                    json_stack.pop();
-                    json_stack.top().put_value(s, json_value(token_reader.read_number()));
-                    expect = EXPECT_END_OBJECT | EXPECT_COMMA;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected number.");
-            }
-            case BOOLEAN: {
-                if (expect & EXPECT_SINGLE_VALUE) {
-                    json_value json(token_reader.read_boolean());
-                    json_stack.push(json);
-                    expect = EXPECT_END_DOCUMENT;
-                    continue;
-                }
-                if (expect & EXPECT_ARRAY_VALUE) {
-                    json_stack.top().push_array(json_value(token_reader.read_boolean()));
-                    expect = EXPECT_END_ARRAY | EXPECT_COMMA;
-                    continue;
-                }
-                if (expect & EXPECT_OBJECT_VALUE) {
-                    std::string s = json_stack.top().get_string();
-                    json_stack.pop();
-                    json_stack.top().put_value(s, json_value(token_reader.read_boolean()));
-                    expect = EXPECT_END_OBJECT | EXPECT_COMMA;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected boolean.");
-            }
-            case STRING: {
-                if (expect & EXPECT_SINGLE_VALUE) {
-                    json_value json(token_reader.read_string());
-                    json_stack.push(json);
-                    expect = EXPECT_END_DOCUMENT;
-                    continue;
-                }
-                if (expect & EXPECT_ARRAY_VALUE) {
-                    json_stack.top().push_array(json_value(token_reader.read_string()));
-                    expect = EXPECT_END_ARRAY | EXPECT_COMMA;
-                    continue;
-                }
-                if (expect & EXPECT_OBJECT_VALUE) {
-                    std::string s = json_stack.top().get_string();
-                    json_stack.pop();
-                    json_stack.top().put_value(s, json_value(token_reader.read_string()));
-                    expect = EXPECT_END_OBJECT | EXPECT_COMMA;
-                    continue;
-                }
-                if (expect & EXPECT_OBJECT_KEY) {
-                    json_stack.push(json_value(token_reader.read_string()));
-                    expect = EXPECT_COLON;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected string.");
-            }
-            case NULL_VALUE: {
-                token_reader.read_null();
-                if (expect & EXPECT_SINGLE_VALUE) {
-                    json_value json;
-                    json.set(nullptr);
-                    json_stack.push(json);
-                    expect = EXPECT_END_DOCUMENT;
-                    continue;
-                }
-                if (expect & EXPECT_ARRAY_VALUE) {
-                    json_stack.top().push_array(json_value(nullptr));
-                    expect = EXPECT_END_ARRAY | EXPECT_COMMA;
-                    continue;
-                }
-                if (expect & EXPECT_OBJECT_VALUE) {
-                    std::string s = json_stack.top().get_string();
-                    json_stack.pop();
-                    json_stack.top().put_value(s, json_value(nullptr));
-                    expect = EXPECT_END_OBJECT | EXPECT_COMMA;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected null.");
-            }
-            case BEGIN_ARRAY: {
-                token_reader.pass_char();
-                if (expect & EXPECT_BEGIN_ARRAY) {
-                    std::vector<std::shared_ptr<json_node>> v;
-                    json_stack.push(json_value(v));
-                    expect = EXPECT_ARRAY_VALUE | EXPECT_BEGIN_OBJECT | EXPECT_BEGIN_ARRAY | EXPECT_END_ARRAY;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected begin of array : [.");
-            }
-            case BEGIN_OBJECT: {
-                token_reader.pass_char();
-                if (expect & EXPECT_BEGIN_OBJECT) {
-                    std::unordered_map<std::string, std::shared_ptr<json_node>> m;
-                    json_stack.push(json_value(m));
-                    expect = EXPECT_OBJECT_KEY | EXPECT_BEGIN_OBJECT | EXPECT_END_OBJECT;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected begin of array : {.");
-            }
-            case END_ARRAY: {
-                token_reader.pass_char();
-                if (expect & EXPECT_END_ARRAY) {
-                    json_value array = json_stack.top();
-                    json_stack.pop();
-                    if (json_stack.empty()) {
-                        json_stack.push(array);
-                        expect = EXPECT_END_DOCUMENT;
-                        continue;
-                    }
-                    if (json_stack.top().has_type<std::string>()) {
-                        std::string s = json_stack.top().get_string();
-                        json_stack.pop();
-                        json_stack.top().put_value(s, array);
-                        expect = EXPECT_COMMA | EXPECT_END_OBJECT;
-                        continue;
-                    }
-                    if (json_stack.top().has_type<std::vector<std::shared_ptr<json_node>>>()) {
-                        json_stack.top().push_array(array);
-                        expect = EXPECT_END_ARRAY | EXPECT_COMMA;
-                        continue;
-                    }
-                }
-                throw std::runtime_error("Unexpected end of array : ].");
-            }
-            case END_OBJECT: {
-                token_reader.pass_char();
-                if (expect & EXPECT_END_OBJECT) {
-                    // std::cout << "Enter end object\n";
-                    json_value object = json_stack.top();
-                    json_stack.pop();
-                    if (json_stack.empty()) {
-                        json_stack.push(object);
-                        expect = EXPECT_END_DOCUMENT;
-                        continue;
-                    }
-                    if (json_stack.top().has_type<std::string>()) {
-                        std::string s = json_stack.top().get_string();
-                        json_stack.pop();
-                        json_stack.top().put_value(s, object);
-                        expect = EXPECT_COMMA | EXPECT_END_OBJECT;
-                        continue;
-                    }
-                    if (json_stack.top().has_type<std::vector<std::shared_ptr<json_node>>>()) {
-                        json_stack.top().push_array(object);
-                        expect = EXPECT_END_ARRAY | EXPECT_COMMA;
-                        continue;
-                    }
-                }
-                throw std::runtime_error("Unexpected end of object : }.");
-            }
-            //* :
-            case SEP_COLON: {
-                token_reader.pass_char();
-                if (expect & EXPECT_COLON) {
-                    expect = EXPECT_OBJECT_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
-                    continue;
-                }
-                throw std::runtime_error("Unexpected colon.");
-            }
-            //* ,
-            case SEP_COMMA: {
-                token_reader.pass_char();
-                if (expect & EXPECT_COMMA) {
-                    if (expect & EXPECT_END_OBJECT) {
-                        expect = EXPECT_OBJECT_KEY;
-                        continue;
-                    }
-                    if (expect & EXPECT_END_ARRAY) {
-                        expect = EXPECT_ARRAY_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
-                        continue;
-                    }
-                }
-                throw std::runtime_error("Unexpected comma.");
-            }
-            case END_DOCUMENT: {
-                if (expect & EXPECT_END_DOCUMENT) {
-                    json_value json = json_stack.top();
-                    json_stack.pop();
-                    if (json_stack.empty()) {
-                        // std::cout << "json parse success, return json." << std::endl;
-                        return json;
-                    }
-                }
-                throw std::runtime_error("Unexpected end of document.");
-            }
+    token_reader.reset(data, size);
+}
+void json_parser::locate(const json_parse_error& e) const
+{
+    if (e.offset() != json_parse_error::npos) {
+        throw;
+    }
+    throw e.at(token_reader.offset());
+}
+// class json_document_builder
+json_document_builder::json_document_builder(json_document& doc, duplicate_key_policy duplicates)
+{
+    bind(doc, duplicates);
+}
+void json_document_builder::reset(json_document& doc, duplicate_key_policy duplicates)
+{
+    bind(doc, duplicates);
+    //* 反复使用的 builder 与 json_grammar 的容器栈一样预留, 层数由 json_grammar 限制
+    containers.reserve(json_grammar::reserved_depth);
+}
+void json_document_builder::bind(json_document& doc, duplicate_key_policy duplicates)
+{
+    this->doc        = &doc;
+    arena            = doc.arena.get();
+    this->duplicates = duplicates;
+    containers.clear();
+    if (keys != doc.keys.get()) {
+        //* 换了驻留表, 缓存里的键都不能再用
+        keys = doc.keys.get();
+        recent.assign(keys != nullptr ? recent_size : 0, json_key());
+    }
+}
+bool json_document_builder::on_begin_object()
+{
+    json_value* object = arena->create<json_value>(json_object(arena));
+    attach(object);
+    containers.push_back(object);
+    return true;
+}
+bool json_document_builder::on_begin_array()
+{
+    json_value* array = arena->create<json_value>(json_array(arena));
+    attach(array);
+    containers.push_back(array);
+    return true;
+}
+bool json_document_builder::on_end_object()
+{
+    containers.pop_back();
+    return true;
+}
+bool json_document_builder::on_end_array()
+{
+    containers.pop_back();
+    return true;
+}
+bool json_document_builder::on_key(std::string_view k)
+{
+    if (keys == nullptr) {
+        key.assign(k.data(), k.size());
+        return true;
+    }
+    //* 同一个文档里的键大多反复出现, 先查最近用过的键, 命中时不用碰表的锁
+    std::size_t hash = std::hash<std::string_view>()(k);
+    json_key&   slot = recent[hash % recent_size];
+    if (!slot || slot.hash() != hash || slot.str() != k) {
+        slot = keys->intern(k, hash);
+    }
+    interned = slot;
+    return true;
+}
+bool json_document_builder::on_string(std::string_view s)
+{
+    attach(arena->create<json_value>(s, arena));
+    return true;
+}
+bool json_document_builder::on_number(const json_number& n)
+{
+    attach(arena->create<json_value>(n));
+    return true;
+}
+bool json_document_builder::on_boolean(bool b)
+{
+    attach(arena->create<json_value>(b));
+    return true;
+}
+bool json_document_builder::on_null()
+{
+    attach(arena->create<json_value>(nullptr));
+    return true;
+}
+void json_document_builder::attach(json_value* value)
+{
+    if (containers.empty()) {
+        doc->root_value = value;
+    } else if (containers.back()->has_type<json_object>()) {
+        if (keys != nullptr) {
+            containers.back()->put_value(interned, value, duplicates);
+        } else {
+            containers.back()->put_value(key, value, duplicates);
         }
+    } else {
+        containers.back()->push_array(value);
+    }
+}
+// class json_document_builder
+
+json_document json_parser::parse()
+{
+    json_document doc(token_reader.input_size());
+    parse(doc);
+    return doc;
+}
+void json_parser::parse(json_document& doc)
+{
+    doc.clear();
+    doc.keys = keys;
+    //* builder 跟着解析器反复使用, 第一次也经过 reset 预留容器栈
+    if (builder == nullptr) {
+        builder = std::make_unique<json_document_builder>(doc, duplicates);
     }
-};
+    builder->reset(doc, duplicates);
+    parse(*builder);
+    JSON_STATS(token_reader.stats().arena_used = doc.arena->bytes_used();
+               token_reader.stats().arena_reserved = doc.arena->bytes_reserved());
+}
@@ -1,14 +1,24 @@
 #pragma once
 
+#include "json_number.hpp"
+#include "json_simd.hpp"
+
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <chrono>
+#include <cstdint>
 #include <cstdio>
 #include <fmt/format.h>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -17,6 +27,11 @@
 namespace json {
 
 class json_value;
+class json_tape;
+class json_document_builder;
+class json_grammar;
+class json_parallel_parser;
+class json_key_table;
 
 enum token_type : uint16_t {
     END_DOCUMENT = 1,
@@ -50,88 +65,676 @@ enum expect_token_type : uint16_t {
     EXPECT_END_DOCUMENT = 1024
 };
 
+//* 编译时打开 JSON_PARSER_STATS(make STATS=1)才统计, 默认关闭, 关闭时统计代码整个不参与编译.
+//* 所有目标文件必须用同一个设置编译
+#ifndef JSON_PARSER_STATS
+#define JSON_PARSER_STATS 0
+#endif
+#if JSON_PARSER_STATS
+#define JSON_STATS(...) __VA_ARGS__
+#else
+#define JSON_STATS(...)
+#endif
+
+//* 一次解析的统计, 解析结束后由 json_parser::stats() 读取. 没有打开 JSON_PARSER_STATS 时全为 0
+struct json_parse_stats {
+    std::array<uint64_t, 12> tokens{};  // 按 token_type 计数, 下标见 token_index()
+
+    uint64_t input_bytes     = 0;  // 输入大小
+    uint64_t scanned_bytes   = 0;  // stage 1 扫描过的字节数
+    uint64_t windows         = 0;  // stage 1 扫描的窗口数
+    uint64_t structurals     = 0;  // stage 1 找到的结构字符数
+    uint64_t string_bytes    = 0;  // 字符串和键的原始字节数, 不含引号
+    uint64_t escaped_strings = 0;  // 带转义、需要解码的字符串个数
+    uint64_t keys            = 0;  // 键的个数, 计在 tokens[STRING] 里
+    uint64_t max_depth       = 0;  // 容器的最大嵌套层数
+    uint64_t arena_used      = 0;  // 建树时文档 arena 分配出去的字节数
+    uint64_t arena_reserved  = 0;  // 建树时文档 arena 向系统要的字节数
+    uint64_t stage1_ns       = 0;  // 结构字符扫描的耗时
+    uint64_t total_ns        = 0;  // 整个解析的耗时, 减去 stage1_ns 就是逐个 token 解析和建树的耗时
+
+    static std::size_t token_index(token_type token)
+    {
+        return __builtin_ctz(token);
+    }
+    uint64_t count(token_type token) const
+    {
+        return tokens[token_index(token)];
+    }
+    //* 字符串值的个数, 不含键
+    uint64_t strings() const
+    {
+        return count(STRING) - keys;
+    }
+    uint64_t numbers() const
+    {
+        return count(NUMBER);
+    }
+};  // struct json_parse_stats
+
+enum trace_event_type : uint8_t {
+    TRACE_PARSE_BEGIN = 1,  // offset 为 0, size 为输入大小
+    TRACE_WINDOW      = 2,  // stage 1 扫描完一个窗口: [offset, offset + size), 耗时 ns
+    TRACE_PARSE_END   = 4   // 解析结束(包括 handler 中途停止, 不包括抛出异常), offset 为停下的位置, ns 为总耗时
+};
+
+//* 跟踪回调收到的事件, stats 是到这个事件为止的统计
+struct json_trace_event {
+    trace_event_type        type;
+    std::size_t             offset;
+    std::size_t             size;
+    uint64_t                ns;
+    const json_parse_stats* stats;
+};
+
+using json_trace_hook = std::function<void(const json_trace_event&)>;
+
+//* 输入不合法. offset 是出错位置相对输入开头的字节偏移, json_parser 抛出的都带着它;
+//* 单独使用 json_grammar 等不知道位置的地方为 npos, 此时 what() 与 message() 相同
+class json_parse_error : public std::runtime_error {
+  public:
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    explicit json_parse_error(const std::string& message, std::size_t offset = npos);
+
+    const std::string& message() const
+    {
+        return text;
+    }
+    std::size_t offset() const
+    {
+        return position;
+    }
+    //* 同样的错误, 补上位置
+    json_parse_error at(std::size_t offset) const
+    {
+        return json_parse_error(text, offset);
+    }
+
+  private:
+    std::string text;
+    std::size_t position;
+};  // class json_parse_error
+
 class json_node {
   public:
   private:
 };  // class json_node
 
+//* 只读映射整个文件, 不支持 mmap 的平台退化为一次性读入内存
+class json_mapped_file {
+  public:
+    //* sequential: 按顺序读整个文件时提示内核预读; 随机访问(例如映射回来的 tape)时传 false
+    explicit json_mapped_file(const std::string& path, bool sequential = true);
+    ~json_mapped_file();
+    json_mapped_file(const json_mapped_file&) = delete;
+    json_mapped_file& operator=(const json_mapped_file&) = delete;
+
+    const char* data() const
+    {
+        return addr;
+    }
+    std::size_t size() const
+    {
+        return length;
+    }
+    //* 已经读过的前 offset 个字节不再需要常驻内存: 交还给内核, 再次访问时会从文件重新读入.
+    //* 顺序读很大的文件时 RSS 因此不会随文件增长
+    void release(std::size_t offset);
+
+  private:
+    const char* addr     = nullptr;
+    std::size_t length   = 0;
+    std::size_t released = 0;  // 已经交还的字节数, 按页对齐
+    std::string contents;
+};  // class json_mapped_file
+
+//* 在一段连续内存上按指针移动游标, 数据来自映射的文件或调用者提供的缓冲区
 class json_char_reader {
   public:
+    static constexpr char eof = std::char_traits<char>::eof();
+
     json_char_reader(std::string& str);
-    char get();
-    char        peek();
-    std::string next(int cnt);
-    bool        has_more();
+    json_char_reader(const char* data, std::size_t size);
+
+    char get()
+    {
+        return cur < last ? *cur++ : eof;
+    }
+    char peek() const
+    {
+        return cur < last ? *cur : eof;
+    }
+    //* 返回接下来 cnt 个字符的视图并跳过, 不足 cnt 个时返回剩余部分
+    std::string_view next(std::size_t cnt)
+    {
+        std::size_t      n = std::min<std::size_t>(cnt, last - cur);
+        std::string_view s(cur, n);
+        cur += n;
+        return s;
+    }
+    bool has_more() const
+    {
+        return cur < last;
+    }
+    std::size_t offset() const
+    {
+        return cur - first;
+    }
+    const char* begin() const
+    {
+        return first;
+    }
+    const char* position() const
+    {
+        return cur;
+    }
+    const char* end() const
+    {
+        return last;
+    }
+    void seek(const char* p)
+    {
+        cur = p;
+    }
+    //* 换成读 [data, data + size), 不再持有之前的文件
+    void reset(const char* data, std::size_t size)
+    {
+        file.reset();
+        first = cur = data;
+        last        = data + size;
+    }
+    //* 当前位置之前的输入已经读完, 来自映射文件时交还这部分内存
+    void release_consumed()
+    {
+        if (file) {
+            file->release(cur - first);
+        }
+    }
 
   private:
-    std::ifstream in;
+    std::shared_ptr<json_mapped_file> file;
+    const char*                       first;
+    const char*                       cur;
+    const char*                       last;
 };  // class json_char_reader
 
+//* 解码 p 处以 '\\' 开头的转义序列, 追加到 out, 返回转义序列之后的位置; 截断或非法时抛出异常
+const char* decode_escape(const char* p, const char* end, std::string& out);
+//* 从 p 开始逐个字符检查, 返回第一个非法 UTF-8 序列的开头; 只在 validate_utf8 已经发现错误时用来定位
+const char* find_invalid_utf8(const char* p, const char* end);
+
 class json_token_reader {
   public:
     json_token_reader(std::string& str);
+    json_token_reader(const char* data, std::size_t size);
+    //* 换一段输入从头读起; 索引数组和解码缓冲区保留, 新输入不比之前的大时不再分配
+    void       reset(const char* data, std::size_t size);
     token_type next_token();
     bool       read_boolean();
-    double     read_number();
-    void        read_null();
-    std::string read_string();
+    //* 整数保持为 int64/uint64, 带小数或指数的才是 double
+    json_number read_number();
+    //* 整数也直接解析成 double
+    double read_double();
+    void read_null();
+    //* 没有转义的字符串直接返回指向输入的视图, 否则解码到内部缓冲区;
+    //* 返回的视图在下一次 read_string() 之前有效
+    std::string_view read_string();
+    //* 不解码转义, 返回引号之间的原始字节, 在输入有效期间一直有效. 只检查控制字符和结尾的引号
+    std::string_view read_raw_string();
 
     void pass_char();
 
+    std::size_t input_size() const
+    {
+        return char_reader.end() - char_reader.begin();
+    }
+    std::size_t offset() const
+    {
+        return char_reader.offset();
+    }
+
+    //* 统计和跟踪, 只在打开 JSON_PARSER_STATS 时更新, 见 json_parse_stats
+    json_parse_stats& stats()
+    {
+        return parse_stats;
+    }
+    const json_parse_stats& stats() const
+    {
+        return parse_stats;
+    }
+    void set_trace_hook(json_trace_hook hook)
+    {
+        trace = std::move(hook);
+    }
+    //* 有跟踪回调时把事件连同当前统计交给它
+    void emit(trace_event_type type, std::size_t offset, std::size_t size, uint64_t ns)
+    {
+        if (trace) {
+            trace(json_trace_event{type, offset, size, ns, &parse_stats});
+        }
+    }
+
   private:
-    json_char_reader char_reader;
+    //* 下一个结构字符的位置, 输入结束时返回 nullptr
+    const char* next_structural()
+    {
+        const char* cur = char_reader.position();
+        while (true) {
+            while (structural_pos < structural_count) {
+                const char* p = window + structurals[structural_pos];
+                if (p >= cur) {
+                    return p;
+                }
+                structural_pos++;
+            }
+            if (scanned == char_reader.end()) {
+                return nullptr;
+            }
+            scan_window();
+        }
+    }
+    void scan_window();
+    //* 索引数组的项数: 输入比一个窗口小时按输入大小分配
+    std::size_t index_capacity() const
+    {
+        return std::min<std::size_t>(window_size, input_size()) + json_structural_scanner::padding;
+    }
+    //* 标量之后必须紧跟空白、结构字符或输入结尾, 否则 stage 1 会把后面的字节当成同一个标量跳过
+    void check_delimiter();
+    //* 抛出 json_parse_error, 位置是 at 相对输入开头的偏移
+    [[noreturn]] void fail(const char* at, const std::string& message) const;
+
+    //* stage 1 按窗口分段扫描, 索引只覆盖当前窗口, 内存占用与输入大小无关
+    static constexpr std::size_t window_size = 64 * 1024;
+
+    json_char_reader            char_reader;
+    json_structural_scanner     scanner;
+    std::unique_ptr<uint32_t[]> structurals;  // 当前窗口内结构字符相对 window 的偏移
+    std::size_t                 structural_capacity;
+    std::size_t                 structural_count = 0;
+    std::size_t                 structural_pos   = 0;
+    const char*                 window           = nullptr;
+    const char*                 scanned          = nullptr;  // 已扫描部分的结尾
+    std::string                 scratch;                     // 带转义的字符串解码到这里
+    json_parse_stats            parse_stats;
+    json_trace_hook             trace;
 };  // class json_token_reader
 
+//* 文档独占的线性(bump)分配器: 节点、字符串和容器都从大块内存里切出来,
+//* 单个节点从不释放, 文档销毁时按块整体归还, 与节点数量无关
+class json_arena final : public std::pmr::memory_resource {
+  public:
+    json_arena() = default;
+    //* size_hint: 预计要分配的字节数. 小文档的第一块按它分配, 不必一上来就占 min_chunk_size
+    explicit json_arena(std::size_t size_hint);
+    ~json_arena();
+    json_arena(const json_arena&) = delete;
+    json_arena& operator=(const json_arena&) = delete;
+
+    //* 在 arena 上构造对象, 对象的析构函数不会被调用
+    template <class T, class... Args> T* create(Args&&... args)
+    {
+        return new (do_allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    void release();
+    //* 之前分配的对象全部作废, 只留下最大的一块给之后的分配用. 反复建同样大小的文档时不再向系统要内存
+    void reset();
+
+    std::size_t bytes_used() const
+    {
+        return used;
+    }
+    std::size_t bytes_reserved() const
+    {
+        return reserved;
+    }
+
+  private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override
+    {
+        char* p = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(cur) + align - 1) & ~(std::uintptr_t)(align - 1));
+        if (p + bytes > limit) {
+            return grow(bytes, align);
+        }
+        cur = p + bytes;
+        used += bytes;
+        return p;
+    }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+    void* grow(std::size_t bytes, std::size_t align);
+
+    struct chunk {
+        chunk*      prev;
+        std::size_t size;
+    };
+    static constexpr std::size_t min_chunk_size   = 64 * 1024;
+    static constexpr std::size_t small_chunk_size = 1024;
+
+    std::size_t first_chunk = min_chunk_size;  // 第一块的大小, 之后每块按已分配的总量翻倍
+    chunk*      head        = nullptr;
+    char*       cur         = nullptr;
+    char*       limit       = nullptr;
+    std::size_t used        = 0;
+    std::size_t reserved    = 0;
+};  // class json_arena
+
+using json_string = std::pmr::string;
+using json_array  = std::pmr::vector<json_value*>;
+
+//* 对象里出现重复的键时怎么处理
+enum duplicate_key_policy : uint8_t {
+    DUPLICATE_KEY_LAST  = 1,  // 后出现的值覆盖前面的, 键留在第一次出现的位置(默认)
+    DUPLICATE_KEY_FIRST = 2,  // 保留第一次出现的值
+    DUPLICATE_KEY_ERROR = 4,  // 抛出异常
+    DUPLICATE_KEY_KEEP  = 8   // 不检查, 全部保留, 查找返回第一个; 解析时省掉每个键的查重
+};
+
+//* 驻留的键: 指向 json_key_table 里的一个条目, 同一个表里内容相同的键是同一个条目,
+//* 比较两个键只需要比较指针, 哈希值在驻留时已经算好. 条目在表销毁前有效
+class json_key {
+  public:
+    json_key() = default;
+
+    std::string_view str() const
+    {
+        return e ? std::string_view(reinterpret_cast<const char*>(e + 1), e->size) : std::string_view();
+    }
+    //* 与 std::hash<std::string_view> 的结果相同
+    std::size_t hash() const
+    {
+        return e ? e->hash : std::hash<std::string_view>()(std::string_view());
+    }
+    const json_key_table* table() const
+    {
+        return e ? e->table : nullptr;
+    }
+    explicit operator bool() const
+    {
+        return e != nullptr;
+    }
+    bool operator==(json_key other) const
+    {
+        return e == other.e;
+    }
+    bool operator!=(json_key other) const
+    {
+        return e != other.e;
+    }
+
+  private:
+    friend class json_key_table;
+    friend class json_object;
+
+    //* 条目头, 键的字节紧跟在后面
+    struct entry {
+        std::size_t           hash;
+        const json_key_table* table;
+        uint32_t              size;
+    };
+
+    explicit json_key(const entry* e) : e(e) {}
+    //* 由驻留键的字节找回条目, 只能用于确实来自键表的字节
+    static json_key from_str(std::string_view s)
+    {
+        return json_key(reinterpret_cast<const entry*>(s.data()) - 1);
+    }
+
+    const entry* e = nullptr;
+};  // class json_key
+
+//* 保持插入顺序的扁平对象: 成员连续存放, 键的字节拷贝到 arena 上.
+//* 成员不多时线性查找; 超过 index_threshold 后第一次查找时才建开放寻址的哈希索引, 之后插入时顺带维护.
+//* 除 DUPLICATE_KEY_KEEP 外插入时都要查重, 所以解析出来的大对象索引已经建好, 可以并发只读;
+//* DUPLICATE_KEY_KEEP 的大对象在第一次查找时建索引, 多线程同时读之前先查一次
+class json_object {
+  public:
+    using member         = std::pair<std::string_view, json_value*>;
+    using iterator       = std::pmr::vector<member>::iterator;
+    using const_iterator = std::pmr::vector<member>::const_iterator;
+
+    //* 成员数组、键和索引都从 mr 分配, 不单独释放, 应当是文档的 arena
+    explicit json_object(std::pmr::memory_resource* mr) : members(mr) {}
+    json_object(json_object&&) = default;
+    json_object(const json_object&) = delete;
+    json_object& operator=(const json_object&) = delete;
+
+    //* 插入一个成员. 键已经存在时按 policy 处理并返回 false
+    bool        insert(std::string_view key, json_value* value, duplicate_key_policy policy = DUPLICATE_KEY_LAST);
+    //* 键已经驻留时不再拷贝键的字节; 所有键都来自同一个表时查重和查找只比较指针
+    bool        insert(json_key key, json_value* value, duplicate_key_policy policy = DUPLICATE_KEY_LAST);
+    //* 键对应的值, 没有时返回 nullptr
+    json_value* find(std::string_view key) const;
+    //* 对象的键来自同一个表时只比较指针, 不计算哈希也不比较字符串
+    json_value* find(json_key key) const;
+
+    std::size_t size() const
+    {
+        return members.size();
+    }
+    bool empty() const
+    {
+        return members.empty();
+    }
+    void reserve(std::size_t n)
+    {
+        members.reserve(n);
+    }
+    iterator begin()
+    {
+        return members.begin();
+    }
+    iterator end()
+    {
+        return members.end();
+    }
+    const_iterator begin() const
+    {
+        return members.begin();
+    }
+    const_iterator end() const
+    {
+        return members.end();
+    }
+
+  private:
+    static constexpr std::size_t npos            = std::size_t(-1);
+    static constexpr std::size_t index_threshold = 8;
+
+    std::size_t lookup(std::string_view key) const;
+    std::size_t lookup(json_key key) const;
+    //* 插入新成员并维护索引
+    void        append(std::string_view key, json_value* value);
+    //* 按当前成员数重建索引, 表的大小至少是成员数的两倍
+    void        build_index() const;
+    void        index_insert(uint32_t i) const;
+    std::size_t hash_of(std::string_view key) const
+    {
+        return keys != nullptr ? json_key::from_str(key).hash() : std::hash<std::string_view>()(key);
+    }
+
+    std::pmr::vector<member> members;
+    const json_key_table*    keys       = nullptr;  // 所有键都驻留在这个表里时才设置, 此时键可以按指针比较
+    mutable uint32_t*        index      = nullptr;  // 开放寻址表, 存成员下标 + 1, 0 表示空位
+    mutable uint32_t         index_mask = 0;        // 表大小减一, 0 表示还没有建索引
+};  // class json_object
+
 //std::ostream& operator<<(std::ostream& os, json_value& jv);
 
 class json_value : public json_node {
   public:
     friend class json_parser;
+    friend class json_arena;
+    friend class json_writer;
+    friend class json_document_builder;
+    friend class json_parallel_parser;
+    friend class json_path;
+    friend class json_msgpack_writer;
+    json_value(const json_value&) = delete;
+    json_value& operator=(const json_value&) = delete;
+
   private:
     explicit json_value() : json(nullptr) {}
-    explicit json_value(std::string s): json(s) {}
+    explicit json_value(std::string_view s, std::pmr::memory_resource* mr): json(std::in_place_type<json_string>, s, mr) {}
     explicit json_value(double d): json(d) {}
+    explicit json_value(int64_t i): json(i) {}
+    explicit json_value(uint64_t u): json(u) {}
+    explicit json_value(const json_number& n);
     explicit json_value(bool b): json(b) {}
     explicit json_value(std::nullptr_t): json(nullptr) {}
-    explicit json_value(std::vector<std::shared_ptr<json_node>> v): json(v) {}
-    explicit json_value(std::unordered_map<std::string, std::shared_ptr<json_node>> m): json(m) {}
-
-    auto        get() const;
-    std::string get_string() const;
-    double      get_number() const;
-    bool                                     get_boolean() const;
-    std::vector<std::shared_ptr<json_node>>&                     get_array() ;
-    std::unordered_map<std::string, std::shared_ptr<json_node>>& get_object() ;
-    template <class T> void                                      set(T value);
-    // void set(double value){
-    //     json = value;
-    // }
-    void put_value(std::string key, json_value value);
-    void push_array(json_value value);
-
-    template <class T> bool has_type();
+    explicit json_value(json_array&& v): json(std::move(v)) {}
+    explicit json_value(json_object&& m): json(std::move(m)) {}
+
+    template <class T> void set(T&& value)
+    {
+        json = std::forward<T>(value);
+    }
+    void put_value(std::string_view key, json_value* value, duplicate_key_policy policy = DUPLICATE_KEY_LAST);
+    void put_value(json_key key, json_value* value, duplicate_key_policy policy = DUPLICATE_KEY_LAST);
+    void push_array(json_value* value);
 
     //* 访问json
   public:
-    json_value& operator[](std::string key);
+    //* 节点的类型是否为 T: json_string、double、int64_t、uint64_t、bool、nullptr_t、json_array 或 json_object
+    template <class T> bool has_type() const
+    {
+        return std::holds_alternative<T>(json);
+    }
+
+    //* 拷贝出一个 std::string; 只是读的话用 get_string_view()
+    std::string      get_string() const;
+    //* 指向节点里的字符串, 不拷贝, 在文档销毁或 clear() 之前有效
+    std::string_view get_string_view() const;
+    //* 任意数字都可以按 double 读取, 超过 2^53 的整数会损失精度
+    double get_number() const;
+    //* 只有值是整数并且在对应类型范围内时才能按整数读取, 否则抛出异常
+    int64_t  get_int64() const;
+    uint64_t get_uint64() const;
+    bool     is_integer() const;
+    bool     get_boolean() const;
+
+    //* 容器本身的引用, 不拷贝; 类型不符时抛出 std::bad_variant_access
+    json_array&        get_array();
+    const json_array&  get_array() const;
+    json_object&       get_object();
+    const json_object& get_object() const;
+
+    json_value& operator[](std::string_view key);
+    //* 文档用键表解析时, 用同一个表驻留的键查找只比较指针
+    json_value& operator[](json_key key);
     json_value& operator[](std::size_t index);
 
-    std::string to_string();
+    //* 紧凑格式; indent 大于 0 时按该缩进美化输出
+    std::string to_string(int indent = 0) const;
 
     // friend std::ostream& operator<<(std::ostream& os, json_value& jv);
 
   private:
-    std::variant<std::string, double, std::unordered_map<std::string, std::shared_ptr<json_node>>, bool, nullptr_t, std::vector<std::shared_ptr<json_node>>>
-        json;
+    std::variant<json_string, double, json_object, bool, nullptr_t, json_array, int64_t, uint64_t> json;
 };  // class json_value
 
+//* 解析结果, 持有 arena 和根节点; 所有节点的生命周期都跟随文档
+class json_document {
+  public:
+    friend class json_parser;
+    friend class json_document_builder;
+    friend class json_parallel_parser;
+    friend class json_extractor;
+    friend class json_msgpack_parser;
+    json_document();
+
+    json_value& root();
+    json_arena& get_arena();
+    //* 丢掉所有节点, arena 的内存留给下一次解析, 见 json_parser::parse(json_document&)
+    void        clear();
+
+    json_value& operator[](std::string_view key);
+    json_value& operator[](json_key key);
+    json_value& operator[](std::size_t index);
+
+    std::string to_string(int indent = 0);
+
+  private:
+    //* 按输入大小估计树的大小, 给 arena 的第一块定尺寸
+    explicit json_document(std::size_t input_size);
+
+    std::unique_ptr<json_arena>              arena;
+    std::vector<std::unique_ptr<json_arena>> parts;  // 并行解析时各段自己的 arena, 节点分散在这些 arena 里
+    std::shared_ptr<json_key_table>          keys;   // 键驻留在这个表里时, 文档持有它以保证键有效
+    json_value*                              root_value = nullptr;
+};  // class json_document
+
 class json_parser {
   public:
+    //* 没有输入, 先用 reset() 给出输入再解析
+    json_parser();
     json_parser(std::string& str);
-    json_value parse();
+    json_parser(const char* data, std::size_t size);
+    ~json_parser();
+    json_parser(json_parser&&) noexcept;
+    json_parser& operator=(json_parser&&) noexcept;
+
+    //* 换一段输入, 解析器内部的缓冲区保留. 反复解析小消息时配合 parse(json_document&) 使用
+    void reset(const char* data, std::size_t size);
+
+    json_document parse();
+    //* 解析到已有的文档里: 先 clear() 它, 节点建在它原来的 arena 上.
+    //* 同一个解析器和文档反复使用时, 稳定以后每次解析都不再分配堆内存
+    void          parse(json_document& doc);
+    //* 解析为扁平的 tape 表示, 见 json_tape.hpp
+    json_tape parse_tape();
+    //* 不建树, 按顺序把事件推给 handler, 定义见 json_sax.hpp.
+    //* handler 中途返回 false 时返回 false
+    template <class Handler> bool parse(Handler& handler);
+    //* 从 grammar 当前的状态接着解析, 输入结束时返回 true 而不检查顶层值是否完整.
+    //* 预先让 grammar 进入一个容器, 就可以解析容器中间的一段元素
+    template <class Handler> bool parse(Handler& handler, json_grammar& grammar);
+
+    //* parse() 建树时重复的键怎么处理, 默认后出现的覆盖前面的. tape 总是保留全部成员
+    void set_duplicate_key_policy(duplicate_key_policy policy)
+    {
+        duplicates = policy;
+    }
+    //* parse() 建树时把键驻留到 table 里, 见 json_intern.hpp. 多个解析器(包括不同线程上的)可以共用一个表
+    void set_key_table(std::shared_ptr<json_key_table> table)
+    {
+        keys = std::move(table);
+    }
+    //* 容器最多嵌套多少层, 超过时在那个 '[' 或 '{' 处抛出 json_parse_error, 默认 json_grammar::default_max_depth
+    void set_max_depth(std::size_t depth)
+    {
+        max_depth = depth;
+    }
+
+    //* 最近一次解析的统计, 需要编译时打开 JSON_PARSER_STATS, 否则全为 0
+    const json_parse_stats& stats() const
+    {
+        return token_reader.stats();
+    }
+    //* 解析开始、stage 1 每扫描完一个窗口、解析结束时回调 hook, 同样只在打开 JSON_PARSER_STATS 时生效.
+    //* 按窗口而不是按 token 回调, 打开跟踪也不会让解析慢一个数量级
+    void set_trace_hook(json_trace_hook hook)
+    {
+        token_reader.set_trace_hook(std::move(hook));
+    }
 
   private:
-    json_token_reader token_reader;
+    //* parse_tape() 用这个 SAX handler 建立 tape, parse() 用的是 json_document_builder
+    class tape_builder;
+
+    //* 在 catch 里调用: 不带位置的错误(来自 json_grammar 或 handler)补上当前的偏移再抛出
+    [[noreturn]] void locate(const json_parse_error& e) const;
+
+    json_token_reader                      token_reader;
+    duplicate_key_policy                   duplicates = DUPLICATE_KEY_LAST;
+    std::size_t                            max_depth;
+    std::shared_ptr<json_key_table>        keys;
+    std::unique_ptr<json_grammar>          grammar;  // 以下两个跨多次解析保留, 容器栈不用每次重新分配
+    std::unique_ptr<json_document_builder> builder;
 };  // class json_parser
 
 
@@ -0,0 +1,342 @@
+#include "json_path.hpp"
+
+using namespace json;
+
+namespace {
+
+[[noreturn]] void invalid_path(std::string_view text)
+{
+    throw std::runtime_error(fmt::format("Invalid json path : {}", text));
+}
+
+//* "0" 或者不以 0 开头的十进制数才能作为数组下标
+std::size_t parse_index(std::string_view s)
+{
+    if (s.empty() || s.size() > 18 || (s.size() > 1 && s[0] == '0')) {
+        return json_path::npos;
+    }
+    std::size_t index = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') {
+            return json_path::npos;
+        }
+        index = index * 10 + (c - '0');
+    }
+    return index;
+}
+
+}  // namespace
+
+// class json_path
+json_path json_path::pointer(std::string_view text)
+{
+    json_path result;
+    if (text.empty()) {
+        return result;
+    }
+    if (text[0] != '/') {
+        throw std::runtime_error(fmt::format("Invalid json pointer : {}", text));
+    }
+    std::size_t pos = 1;
+    while (true) {
+        std::size_t slash = std::min(text.find('/', pos), text.size());
+        step        s;
+        s.is_key = true;
+        for (std::size_t i = pos; i < slash; i++) {
+            if (text[i] != '~') {
+                s.key.push_back(text[i]);
+            } else if (i + 1 < slash && (text[i + 1] == '0' || text[i + 1] == '1')) {
+                s.key.push_back(text[++i] == '0' ? '~' : '/');
+            } else {
+                throw std::runtime_error(fmt::format("Invalid json pointer : {}", text));
+            }
+        }
+        s.index = parse_index(s.key);
+        result.path.push_back(std::move(s));
+        if (slash == text.size()) {
+            return result;
+        }
+        pos = slash + 1;
+    }
+}
+json_path json_path::parse(std::string_view text)
+{
+    json_path result;
+    if (text.empty() || text[0] != '$') {
+        invalid_path(text);
+    }
+    std::size_t i = 1;
+    while (i < text.size()) {
+        step s;
+        if (text[i] == '.') {
+            i++;
+            if (i < text.size() && text[i] == '*') {
+                s.wildcard = true;
+                i++;
+            } else {
+                std::size_t end = std::min(text.find_first_of(".[", i), text.size());
+                if (end == i) {
+                    invalid_path(text);  // 空的名字, 或者不支持的递归下降 ".."
+                }
+                s.key.assign(text.data() + i, end - i);
+                s.is_key = true;
+                i        = end;
+            }
+        } else if (text[i] == '[') {
+            i++;
+            if (i < text.size() && text[i] == '*') {
+                s.wildcard = true;
+                i++;
+            } else if (i < text.size() && (text[i] == '\'' || text[i] == '"')) {
+                //* 引号括起来的键, 反斜杠转义其后的一个字符
+                char quote = text[i++];
+                while (i < text.size() && text[i] != quote) {
+                    if (text[i] == '\\' && i + 1 < text.size()) {
+                        i++;
+                    }
+                    s.key.push_back(text[i++]);
+                }
+                if (i == text.size()) {
+                    invalid_path(text);
+                }
+                s.is_key = true;
+                i++;
+            } else {
+                std::size_t end = std::min(text.find(']', i), text.size());
+                s.index         = parse_index(text.substr(i, end - i));
+                if (s.index == npos) {
+                    invalid_path(text);
+                }
+                i = end;
+            }
+            if (i >= text.size() || text[i] != ']') {
+                invalid_path(text);
+            }
+            i++;
+        } else {
+            invalid_path(text);
+        }
+        result.path.push_back(std::move(s));
+    }
+    return result;
+}
+bool json_path::has_wildcard() const
+{
+    for (const step& s : path) {
+        if (s.wildcard) {
+            return true;
+        }
+    }
+    return false;
+}
+json_value* json_path::find(json_value& root) const
+{
+    if (has_wildcard()) {
+        std::vector<json_value*> all = select(root);
+        return all.empty() ? nullptr : all.front();
+    }
+    json_value* v = &root;
+    for (const step& s : path) {
+        if (v->has_type<json_object>()) {
+            v = s.is_key ? v->get_object().find(s.key) : nullptr;
+            if (v == nullptr) {
+                return nullptr;
+            }
+        } else if (v->has_type<json_array>()) {
+            json_array& array = v->get_array();
+            if (s.index >= array.size()) {
+                return nullptr;
+            }
+            v = array[s.index];
+        } else {
+            return nullptr;
+        }
+    }
+    return v;
+}
+std::vector<json_value*> json_path::select(json_value& root) const
+{
+    std::vector<json_value*> current = {&root};
+    std::vector<json_value*> next;
+    for (const step& s : path) {
+        next.clear();
+        for (json_value* v : current) {
+            if (v->has_type<json_object>()) {
+                json_object& object = v->get_object();
+                if (s.wildcard) {
+                    for (auto& member : object) {
+                        next.push_back(member.second);
+                    }
+                } else if (json_value* member = s.is_key ? object.find(s.key) : nullptr) {
+                    next.push_back(member);
+                }
+            } else if (v->has_type<json_array>()) {
+                json_array& array = v->get_array();
+                if (s.wildcard) {
+                    next.insert(next.end(), array.begin(), array.end());
+                } else if (s.index < array.size()) {
+                    next.push_back(array[s.index]);
+                }
+            }
+        }
+        current.swap(next);
+    }
+    return current;
+}
+// class json_path
+
+// class json_extractor
+json_extractor::json_extractor() : levels(1) {}
+std::size_t json_extractor::add(json_path path)
+{
+    any_wildcard = any_wildcard || path.has_wildcard();
+    levels[0].active.push_back(static_cast<uint32_t>(paths.size()));
+    paths.push_back(std::move(path));
+    results.emplace_back();
+    pending++;
+    return paths.size() - 1;
+}
+void json_extractor::clear()
+{
+    for (std::vector<json_value*>& r : results) {
+        r.clear();
+    }
+    captures.clear();
+    doc     = json_document();
+    depth   = 0;
+    pending = paths.size();
+}
+void json_extractor::enter(bool container)
+{
+    hits.clear();
+    if (container && levels.size() <= depth + 1) {
+        levels.emplace_back();
+    }
+    level& parent = levels[depth];
+    level* child  = container ? &levels[depth + 1] : nullptr;
+    if (child != nullptr) {
+        child->active.clear();
+    }
+    for (uint32_t id : parent.active) {
+        const std::vector<json_path::step>& steps = paths[id].steps();
+        //* 根值不消耗路径; 其余的值用所在容器的键或下标匹配第 depth - 1 步
+        if (depth > 0) {
+            const json_path::step& s = steps[depth - 1];
+            if (!(s.wildcard || (parent.object ? s.is_key && std::string_view(s.key) == key : s.index == parent.index))) {
+                continue;
+            }
+        }
+        if (steps.size() == depth) {
+            hits.push_back(id);
+        } else if (child != nullptr) {
+            child->active.push_back(id);
+        }
+    }
+    if (!hits.empty()) {
+        captures.push_back({json_document_builder(doc), depth});
+    }
+}
+void json_extractor::record()
+{
+    for (uint32_t id : hits) {
+        if (results[id].empty()) {
+            pending--;
+        }
+        results[id].push_back(doc.root_value);
+    }
+}
+bool json_extractor::leave()
+{
+    if (depth > 0 && !levels[depth].object) {
+        levels[depth].index++;
+    }
+    while (!captures.empty() && captures.back().depth == depth) {
+        captures.pop_back();
+    }
+    return any_wildcard || pending > 0 || !captures.empty();
+}
+bool json_extractor::on_begin_object()
+{
+    enter(true);
+    for (capture& c : captures) {
+        c.builder.on_begin_object();
+    }
+    record();
+    depth++;
+    levels[depth].object = true;
+    levels[depth].index  = 0;
+    return true;
+}
+bool json_extractor::on_begin_array()
+{
+    enter(true);
+    for (capture& c : captures) {
+        c.builder.on_begin_array();
+    }
+    record();
+    depth++;
+    levels[depth].object = false;
+    levels[depth].index  = 0;
+    return true;
+}
+bool json_extractor::on_end_object()
+{
+    for (capture& c : captures) {
+        c.builder.on_end_object();
+    }
+    depth--;
+    return leave();
+}
+bool json_extractor::on_end_array()
+{
+    for (capture& c : captures) {
+        c.builder.on_end_array();
+    }
+    depth--;
+    return leave();
+}
+bool json_extractor::on_key(std::string_view k)
+{
+    key.assign(k.data(), k.size());
+    for (capture& c : captures) {
+        c.builder.on_key(k);
+    }
+    return true;
+}
+bool json_extractor::on_string(std::string_view s)
+{
+    enter(false);
+    for (capture& c : captures) {
+        c.builder.on_string(s);
+    }
+    record();
+    return leave();
+}
+bool json_extractor::on_number(const json_number& n)
+{
+    enter(false);
+    for (capture& c : captures) {
+        c.builder.on_number(n);
+    }
+    record();
+    return leave();
+}
+bool json_extractor::on_boolean(bool b)
+{
+    enter(false);
+    for (capture& c : captures) {
+        c.builder.on_boolean(b);
+    }
+    record();
+    return leave();
+}
+bool json_extractor::on_null()
+{
+    enter(false);
+    for (capture& c : captures) {
+        c.builder.on_null();
+    }
+    record();
+    return leave();
+}
+// class json_extractor
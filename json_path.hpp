@@ -0,0 +1,114 @@
+#pragma once
+
+#include "json_sax.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+//* 编译好的路径: 字符串只在创建时解析一次, 之后可以反复对不同文档求值.
+//* 支持 RFC 6901 JSON Pointer 和 JSONPath 的一个子集: $ . ['键'] [下标] [*] .*
+class json_path {
+  public:
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    struct step {
+        json_string key;                // 作为对象的键
+        std::size_t index    = npos;    // 作为数组下标, 不能作为下标时为 npos
+        bool        is_key   = false;   // 可以匹配对象的键
+        bool        wildcard = false;   // 匹配任意键或下标
+    };
+
+    //* "/a/0/b~1c": ~1 表示 '/', ~0 表示 '~'. 全是数字的段既可以是键也可以是下标, 由所在容器决定
+    static json_path pointer(std::string_view text);
+    //* "$.a[0]['b.c'][*].*"
+    static json_path parse(std::string_view text);
+
+    //* 第一个匹配的节点, 没有时返回 nullptr
+    json_value* find(json_value& root) const;
+    json_value* find(json_document& doc) const
+    {
+        return find(doc.root());
+    }
+    //* 所有匹配的节点, 按文档顺序(对象成员按容器的遍历顺序)
+    std::vector<json_value*> select(json_value& root) const;
+
+    const std::vector<step>& steps() const
+    {
+        return path;
+    }
+    //* 没有通配符时最多匹配一个值
+    bool has_wildcard() const;
+
+  private:
+    std::vector<step> path;
+};  // class json_path
+
+//* 一趟解析同时提取多条路径: 作为 SAX handler 交给 json_parser::parse() 或 json_stream_parser,
+//* 不建整棵树, 只把命中的值建成节点. 每层只检查前缀仍然匹配的那些路径, 与路径总数基本无关.
+//* 所有路径都不含通配符时, 每条路径都命中以后立即停止解析(parse 因此返回 false), 剩下的输入不再读取
+class json_extractor final : public json_sax_handler {
+  public:
+    json_extractor();
+
+    //* 加入一条路径, 返回它的编号
+    std::size_t add(json_path path);
+    //* 第 i 条路径命中的值, 按文档顺序; 节点属于 extractor, 下一次 clear() 前有效
+    const std::vector<json_value*>& matches(std::size_t i) const
+    {
+        return results[i];
+    }
+    //* 第 i 条路径的第一个命中, 没有时返回 nullptr
+    json_value* find(std::size_t i) const
+    {
+        return results[i].empty() ? nullptr : results[i].front();
+    }
+    //* 清空结果, 准备提取下一个文档; 路径保留
+    void clear();
+
+    bool on_begin_object() override;
+    bool on_key(std::string_view k) override;
+    bool on_end_object() override;
+    bool on_begin_array() override;
+    bool on_end_array() override;
+    bool on_string(std::string_view s) override;
+    bool on_number(const json_number& n) override;
+    bool on_boolean(bool b) override;
+    bool on_null() override;
+
+  private:
+    //* 每层容器的状态
+    struct level {
+        bool                  object = false;
+        std::size_t           index  = 0;  // 数组里下一个元素的下标
+        std::vector<uint32_t> active;      // 前缀匹配到这一层的路径
+    };
+    struct capture {
+        json_document_builder builder;
+        std::size_t           depth;  // 开始时的嵌套深度, 回到这一层时捕获结束
+    };
+
+    //* 一个值开始: 找出在这里命中的路径(放进 hits)和需要继续向下匹配的路径
+    void enter(bool container);
+    //* 新开始的值已经交给 builder 建好节点, 记录到命中的路径下
+    void record();
+    //* 一个值结束(标量立即结束, 容器在闭合时结束). 返回 false 时停止解析
+    bool leave();
+
+    std::vector<json_path>                paths;
+    std::vector<std::vector<json_value*>> results;
+    std::size_t                           pending      = 0;      // 尚未命中的路径数, 只在没有通配符时用来提前停止
+    bool                                  any_wildcard = false;
+    json_document                         doc;                   // 命中的值建在这里
+    std::vector<level>                    levels;                // levels[d] 是深度 d 的容器, levels[0] 的 active 是全部路径
+    std::size_t                           depth        = 0;      // 尚未闭合的容器层数
+    std::vector<capture>                  captures;              // 正在建的命中值, 可能嵌套
+    std::vector<uint32_t>                 hits;                  // 在当前值命中的路径
+    std::string                           key;                   // 最近一次读到的键
+};  // class json_extractor
+
+}  // namespace json
@@ -0,0 +1,380 @@
+#pragma once
+
+#include "json_parser.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+//* SAX 事件接口: json_parser::parse(handler) 每读到一个值就回调一次, 不建树.
+//* 解析器自己只保留容器嵌套的栈, 内存占用与文档大小无关.
+//* 回调返回 false 时立即停止解析, parse 返回 false.
+//* 字符串和键的视图只在回调期间有效, 需要保留时自行拷贝.
+//* 不需要虚函数开销时可以直接传入任何有同名成员函数的类型
+class json_sax_handler {
+  public:
+    virtual ~json_sax_handler() = default;
+
+    virtual bool on_begin_object()
+    {
+        return true;
+    }
+    virtual bool on_key(std::string_view)
+    {
+        return true;
+    }
+    virtual bool on_end_object()
+    {
+        return true;
+    }
+    virtual bool on_begin_array()
+    {
+        return true;
+    }
+    virtual bool on_end_array()
+    {
+        return true;
+    }
+    virtual bool on_string(std::string_view)
+    {
+        return true;
+    }
+    virtual bool on_number(const json_number&)
+    {
+        return true;
+    }
+    virtual bool on_boolean(bool)
+    {
+        return true;
+    }
+    virtual bool on_null()
+    {
+        return true;
+    }
+};  // class json_sax_handler
+
+//* 把事件建成 json_document 的 handler, json_parser::parse() 就是用它实现的.
+//* 配合流式解析时, 顶层值一完整文档就可以使用
+class json_document_builder final : public json_sax_handler {
+  public:
+    explicit json_document_builder(json_document& doc, duplicate_key_policy duplicates = DUPLICATE_KEY_LAST);
+    //* 改为建到 doc 里, 内部缓冲区的容量保留, 反复使用时不再分配.
+    //* 只使用一次的 builder(构造出来的)不预留容器栈, 容器栈随第一个容器按需分配
+    void reset(json_document& doc, duplicate_key_policy duplicates = DUPLICATE_KEY_LAST);
+
+    bool on_begin_object() override;
+    bool on_key(std::string_view k) override;
+    bool on_end_object() override;
+    bool on_begin_array() override;
+    bool on_end_array() override;
+    bool on_string(std::string_view s) override;
+    bool on_number(const json_number& n) override;
+    bool on_boolean(bool b) override;
+    bool on_null() override;
+
+  private:
+    //* 构造和 reset 共用: 指向 doc, 清空容器栈
+    void bind(json_document& doc, duplicate_key_policy duplicates);
+    //* 新值在创建时就挂到父容器上, 所以不需要额外保存键栈
+    void attach(json_value* value);
+
+    static constexpr std::size_t recent_size = 256;
+
+    json_document*           doc;
+    json_arena*              arena;
+    duplicate_key_policy     duplicates;
+    json_key_table*          keys = nullptr;  // 文档带着驻留表时, 键都经过它驻留
+    std::vector<json_value*> containers;      // 尚未闭合的容器
+    std::string              key;             // 最近一次读到的键, 紧接着的值会用到它
+    json_key                 interned;        // 驻留后的 key
+    std::vector<json_key>    recent;          // 按哈希直接映射的最近驻留的键
+};  // class json_document_builder
+
+//* 语法状态机: 只检查 token 的先后顺序是否合法, 不关心值的内容.
+//* 状态只有 expect 和容器栈, 可以在两次调用之间保存, 一次性解析和流式解析共用它.
+//* 每个函数在 token 不合法时抛出不带位置的 json_parse_error, 否则转移到下一个状态.
+//* 容器栈每层一位, 嵌套超过 max_depth 层时在开始新容器处报错, 恶意的深层输入很快失败而不是一直吃内存
+class json_grammar {
+  public:
+    static constexpr std::size_t default_max_depth = 64 * 1024;
+    //* 容器栈预先留出的层数, 不超过这个深度的文档解析时容器栈不再分配; 更深时按需增长, 但不会超过 max_depth
+    static constexpr std::size_t reserved_depth = 256;
+
+    //* 一个完整的标量值: 字符串、数字、布尔或 null
+    void value(token_type token)
+    {
+        if (!(expect & expect_value)) {
+            unexpected(token);
+        }
+        expect = after_value();
+    }
+    //* 读到字符串时调用, 返回它是对象的键还是一个值
+    bool string_is_key()
+    {
+        if (expect & expect_value) {
+            expect = after_value();
+            return false;
+        }
+        if (expect & EXPECT_OBJECT_KEY) {
+            expect = EXPECT_COLON;
+            return true;
+        }
+        unexpected(STRING);
+    }
+    void begin_array()
+    {
+        if (!(expect & EXPECT_BEGIN_ARRAY)) {
+            unexpected(BEGIN_ARRAY);
+        }
+        if (in_object.size() >= max_depth) {
+            too_deep();
+        }
+        in_object.push_back(false);
+        expect = EXPECT_ARRAY_VALUE | EXPECT_BEGIN_OBJECT | EXPECT_BEGIN_ARRAY | EXPECT_END_ARRAY;
+    }
+    void begin_object()
+    {
+        if (!(expect & EXPECT_BEGIN_OBJECT)) {
+            unexpected(BEGIN_OBJECT);
+        }
+        if (in_object.size() >= max_depth) {
+            too_deep();
+        }
+        in_object.push_back(true);
+        expect = EXPECT_OBJECT_KEY | EXPECT_END_OBJECT;
+    }
+    void end_array()
+    {
+        if (!(expect & EXPECT_END_ARRAY)) {
+            unexpected(END_ARRAY);
+        }
+        in_object.pop_back();
+        expect = after_value();
+    }
+    void end_object()
+    {
+        if (!(expect & EXPECT_END_OBJECT)) {
+            unexpected(END_OBJECT);
+        }
+        in_object.pop_back();
+        expect = after_value();
+    }
+    void colon()
+    {
+        if (!(expect & EXPECT_COLON)) {
+            unexpected(SEP_COLON);
+        }
+        expect = EXPECT_OBJECT_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
+    }
+    void comma()
+    {
+        if (expect & EXPECT_COMMA) {
+            if (expect & EXPECT_END_OBJECT) {
+                expect = EXPECT_OBJECT_KEY;
+                return;
+            }
+            if (expect & EXPECT_END_ARRAY) {
+                expect = EXPECT_ARRAY_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
+                return;
+            }
+        }
+        unexpected(SEP_COMMA);
+    }
+    void end_document()
+    {
+        if (!complete()) {
+            unexpected(END_DOCUMENT);
+        }
+    }
+    //* 顶层值已经完整, 之后只能是输入结尾
+    bool complete() const
+    {
+        return (expect & EXPECT_END_DOCUMENT) != 0;
+    }
+    //* 尚未闭合的容器层数
+    std::size_t depth() const
+    {
+        return in_object.size();
+    }
+    void reset()
+    {
+        expect = EXPECT_SINGLE_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
+        in_object.clear();
+    }
+    //* 只影响之后开始的容器. 同时预留容器栈, json_parser 每次解析都会调用
+    void set_max_depth(std::size_t depth)
+    {
+        max_depth = depth;
+        in_object.reserve(std::min(max_depth, reserved_depth));
+    }
+    std::size_t get_max_depth() const
+    {
+        return max_depth;
+    }
+
+    //* 不该出现的 token, 抛出不带位置的 json_parse_error; 不经过状态机的解析器(见 json_basic_parser.hpp)也用它报错
+    [[noreturn]] static void unexpected(token_type token)
+    {
+        switch (token) {
+            case NUMBER: throw json_parse_error("Unexpected number.");
+            case BOOLEAN: throw json_parse_error("Unexpected boolean.");
+            case NULL_VALUE: throw json_parse_error("Unexpected null.");
+            case STRING: throw json_parse_error("Unexpected string.");
+            case BEGIN_ARRAY: throw json_parse_error("Unexpected begin of array : [.");
+            case BEGIN_OBJECT: throw json_parse_error("Unexpected begin of object : {.");
+            case END_ARRAY: throw json_parse_error("Unexpected end of array : ].");
+            case END_OBJECT: throw json_parse_error("Unexpected end of object : }.");
+            case SEP_COLON: throw json_parse_error("Unexpected colon.");
+            case SEP_COMMA: throw json_parse_error("Unexpected comma.");
+            default: throw json_parse_error("Unexpected end of document.");
+        }
+    }
+
+  private:
+    static constexpr uint16_t expect_value = EXPECT_SINGLE_VALUE | EXPECT_ARRAY_VALUE | EXPECT_OBJECT_VALUE;
+
+    //* 一个完整的值之后, 根据所在的容器决定下一步期待的 token
+    uint16_t after_value() const
+    {
+        if (in_object.empty()) {
+            return EXPECT_END_DOCUMENT;
+        }
+        return in_object.back() ? EXPECT_END_OBJECT | EXPECT_COMMA : EXPECT_END_ARRAY | EXPECT_COMMA;
+    }
+    [[noreturn]] void too_deep() const
+    {
+        throw json_parse_error(fmt::format("Nesting too deep : more than {} levels", max_depth));
+    }
+
+    uint16_t          expect    = EXPECT_SINGLE_VALUE | EXPECT_BEGIN_ARRAY | EXPECT_BEGIN_OBJECT;
+    std::size_t       max_depth = default_max_depth;
+    std::vector<bool> in_object;  // 每层尚未闭合的容器是否为对象
+};  // class json_grammar
+
+template <class Handler> bool json_parser::parse(Handler& handler)
+{
+    if (grammar == nullptr) {
+        grammar = std::make_unique<json_grammar>();
+    }
+    grammar->reset();
+    grammar->set_max_depth(max_depth);
+    JSON_STATS(json_parse_stats& stats = token_reader.stats();
+               stats                   = json_parse_stats();
+               stats.input_bytes       = token_reader.input_size();
+               auto start              = std::chrono::steady_clock::now();
+               token_reader.emit(TRACE_PARSE_BEGIN, 0, stats.input_bytes, 0));
+    bool complete = parse(handler, *grammar);
+    JSON_STATS(stats.total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+               token_reader.emit(TRACE_PARSE_END, token_reader.offset(), 0, stats.total_ns));
+    if (!complete) {
+        return false;
+    }
+    try {
+        grammar->end_document();
+    } catch (const json_parse_error& e) {
+        locate(e);
+    }
+    return true;
+}
+
+template <class Handler> bool json_parser::parse(Handler& handler, json_grammar& grammar)
+try {
+    while (true) {
+        token_type token = token_reader.next_token();
+        switch (token) {
+            case BLANK: {
+                token_reader.pass_char();
+                continue;
+            }
+            case NUMBER: {
+                grammar.value(NUMBER);
+                if (!handler.on_number(token_reader.read_number())) {
+                    return false;
+                }
+                continue;
+            }
+            case BOOLEAN: {
+                grammar.value(BOOLEAN);
+                if (!handler.on_boolean(token_reader.read_boolean())) {
+                    return false;
+                }
+                continue;
+            }
+            case NULL_VALUE: {
+                grammar.value(NULL_VALUE);
+                token_reader.read_null();
+                if (!handler.on_null()) {
+                    return false;
+                }
+                continue;
+            }
+            case STRING: {
+                bool is_key = grammar.string_is_key();
+                JSON_STATS(token_reader.stats().keys += is_key);
+                if (!(is_key ? handler.on_key(token_reader.read_string()) : handler.on_string(token_reader.read_string()))) {
+                    return false;
+                }
+                continue;
+            }
+            case BEGIN_ARRAY: {
+                grammar.begin_array();
+                token_reader.pass_char();
+                JSON_STATS(token_reader.stats().max_depth = std::max<uint64_t>(token_reader.stats().max_depth, grammar.depth()));
+                if (!handler.on_begin_array()) {
+                    return false;
+                }
+                continue;
+            }
+            case BEGIN_OBJECT: {
+                grammar.begin_object();
+                token_reader.pass_char();
+                JSON_STATS(token_reader.stats().max_depth = std::max<uint64_t>(token_reader.stats().max_depth, grammar.depth()));
+                if (!handler.on_begin_object()) {
+                    return false;
+                }
+                continue;
+            }
+            case END_ARRAY: {
+                grammar.end_array();
+                token_reader.pass_char();
+                if (!handler.on_end_array()) {
+                    return false;
+                }
+                continue;
+            }
+            case END_OBJECT: {
+                grammar.end_object();
+                token_reader.pass_char();
+                if (!handler.on_end_object()) {
+                    return false;
+                }
+                continue;
+            }
+            //* :
+            case SEP_COLON: {
+                grammar.colon();
+                token_reader.pass_char();
+                continue;
+            }
+            //* ,
+            case SEP_COMMA: {
+                grammar.comma();
+                token_reader.pass_char();
+                continue;
+            }
+            case END_DOCUMENT: {
+                return true;
+            }
+        }
+    }
+} catch (const json_parse_error& e) {
+    locate(e);
+}
+
+}  // namespace json
@@ -0,0 +1,523 @@
+#include "json_simd.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    include <immintrin.h>
+#    define JSON_SIMD_X86 1
+#endif
+
+using namespace json;
+
+namespace {
+
+using scan_state = json_structural_scanner::scan_state;
+
+struct block_masks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;  // { } [ ] : ,
+    uint64_t ws;  // 空格 \t \n \r
+};
+
+inline uint64_t prefix_xor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+//* 找出被奇数个连续反斜杠转义的字符: 从偶数位开始的反斜杠串加上起点后进位落在奇数位,
+//* 反之亦然, 落点就是被转义的字符. state.escaped 记录上一块是否以奇数长度的反斜杠串结束
+inline uint64_t find_escaped(uint64_t backslash, scan_state& state)
+{
+    constexpr uint64_t even_bits = 0x5555555555555555ULL;
+    constexpr uint64_t odd_bits  = ~even_bits;
+
+    uint64_t start_edges     = backslash & ~(backslash << 1);
+    uint64_t even_start_mask = even_bits ^ state.escaped;
+    uint64_t even_starts     = start_edges & even_start_mask;
+    uint64_t odd_starts      = start_edges & ~even_start_mask;
+    uint64_t even_carries    = backslash + even_starts;
+    uint64_t odd_carries     = backslash + odd_starts;
+    bool     ends_odd        = odd_carries < backslash;
+    odd_carries |= state.escaped;
+    state.escaped = ends_odd ? 1 : 0;
+
+    uint64_t even_carry_ends = even_carries & ~backslash;
+    uint64_t odd_carry_ends  = odd_carries & ~backslash;
+    return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+//* 由一块的四个掩码算出结构位置掩码
+inline uint64_t structurals(const block_masks& m, scan_state& state)
+{
+    uint64_t escaped   = find_escaped(m.backslash, state);
+    uint64_t quote     = m.quote & ~escaped;
+    uint64_t in_string = prefix_xor(quote) ^ state.in_string;
+    state.in_string    = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+    //* 标量的起点: 前一个字节不是标量的非引号、非结构、非空白字节
+    uint64_t scalar       = ~(m.op | m.ws | m.quote);
+    uint64_t follows      = (scalar << 1) | state.scalar;
+    state.scalar          = scalar >> 63;
+    uint64_t scalar_start = scalar & ~follows;
+
+    //* in_string 包含起始引号而不包含结束引号
+    return ((m.op | scalar_start) & ~in_string) | (quote & in_string);
+}
+
+//* 把位掩码展开成下标. 每轮无条件写 4 个, 多写的部分落在调用者预留的 64 项余量里
+inline uint32_t* flatten(uint64_t bits, uint32_t base, uint32_t* out)
+{
+    uint32_t* next = out + __builtin_popcountll(bits);
+    while (bits != 0) {
+        out[0] = base + static_cast<uint32_t>(__builtin_ctzll(bits));
+        bits &= bits - 1;
+        out[1] = base + static_cast<uint32_t>(__builtin_ctzll(bits | (uint64_t(1) << 63)));
+        bits &= bits - 1;
+        out[2] = base + static_cast<uint32_t>(__builtin_ctzll(bits | (uint64_t(1) << 63)));
+        bits &= bits - 1;
+        out[3] = base + static_cast<uint32_t>(__builtin_ctzll(bits | (uint64_t(1) << 63)));
+        bits &= bits - 1;
+        out += 4;
+    }
+    return next;
+}
+
+enum char_class : uint8_t { CLASS_NONE = 0, CLASS_QUOTE = 1, CLASS_BACKSLASH = 2, CLASS_OP = 4, CLASS_WS = 8 };
+
+struct class_table {
+    uint8_t c[256] = {};
+    constexpr class_table()
+    {
+        c[uint8_t('"')]  = CLASS_QUOTE;
+        c[uint8_t('\\')] = CLASS_BACKSLASH;
+        for (const char* op = "{}[]:,"; *op != '\0'; op++) {
+            c[uint8_t(*op)] = CLASS_OP;
+        }
+        for (const char* ws = " \t\n\r"; *ws != '\0'; ws++) {
+            c[uint8_t(*ws)] = CLASS_WS;
+        }
+    }
+};
+constexpr class_table char_classes;
+
+//* UTF-8 校验采用 Keiser & Lemire 的查表法: 用前一个字节的高/低 4 位和当前字节的高 4 位
+//* 各查一张表, 三者按位与后非零即出错; 第三、四个字节是否必须是续字节再单独检查
+constexpr uint8_t TOO_SHORT      = 1 << 0;  // 11______ 0_______ / 11______ 11______
+constexpr uint8_t TOO_LONG       = 1 << 1;  // 0_______ 10______
+constexpr uint8_t OVERLONG_3     = 1 << 2;  // 11100000 100_____
+constexpr uint8_t TOO_LARGE      = 1 << 3;  // 11110100 1001____ 及更大
+constexpr uint8_t SURROGATE      = 1 << 4;  // 11101101 101_____
+constexpr uint8_t OVERLONG_2     = 1 << 5;  // 1100000_ 10______
+constexpr uint8_t TOO_LARGE_1000 = 1 << 6;  // 11110101 1000____ 及更大
+constexpr uint8_t OVERLONG_4     = 1 << 6;  // 11110000 1000____
+constexpr uint8_t TWO_CONTS      = 1 << 7;  // 10______ 10______
+constexpr uint8_t CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+alignas(16) constexpr uint8_t utf8_byte_1_high[16] = {
+    TOO_LONG,  TOO_LONG,  TOO_LONG,  TOO_LONG,  TOO_LONG,  TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, TOO_SHORT | OVERLONG_2, TOO_SHORT, TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4};
+alignas(16) constexpr uint8_t utf8_byte_1_low[16] = {
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, CARRY | OVERLONG_2, CARRY, CARRY, CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000};
+alignas(16) constexpr uint8_t utf8_byte_2_high[16] = {
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT};
+
+//* 上一块的最后三个字节是否停在一个多字节序列中间
+inline bool utf8_incomplete(uint32_t prev)
+{
+    return uint8_t(prev >> 24) >= 0xC0 || uint8_t(prev >> 16) >= 0xE0 || uint8_t(prev >> 8) >= 0xF0;
+}
+
+inline void validate_utf8_scalar(const char* p, scan_state& state)
+{
+    uint64_t word[8];
+    std::memcpy(word, p, 64);
+    if (((word[0] | word[1] | word[2] | word[3] | word[4] | word[5] | word[6] | word[7]) & 0x8080808080808080ULL) == 0) {
+        state.utf8_error |= utf8_incomplete(state.utf8_prev);
+    }
+    else {
+        uint8_t p3 = uint8_t(state.utf8_prev >> 8), p2 = uint8_t(state.utf8_prev >> 16), p1 = uint8_t(state.utf8_prev >> 24);
+        for (int i = 0; i < 64; i++) {
+            uint8_t c      = uint8_t(p[i]);
+            uint8_t sc     = utf8_byte_1_high[p1 >> 4] & utf8_byte_1_low[p1 & 0x0F] & utf8_byte_2_high[c >> 4];
+            uint8_t must23 = (p2 >= 0xE0 || p3 >= 0xF0) ? 0x80 : 0;
+            state.utf8_error |= uint8_t(must23 ^ sc);
+            p3 = p2;
+            p2 = p1;
+            p1 = c;
+        }
+    }
+    std::memcpy(&state.utf8_prev, p + 60, 4);
+}
+
+inline void classify_scalar(const char* p, block_masks& m)
+{
+    m = block_masks{0, 0, 0, 0};
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = uint64_t(1) << i;
+        switch (char_classes.c[uint8_t(p[i])]) {
+            case CLASS_QUOTE: m.quote |= bit; break;
+            case CLASS_BACKSLASH: m.backslash |= bit; break;
+            case CLASS_OP: m.op |= bit; break;
+            case CLASS_WS: m.ws |= bit; break;
+        }
+    }
+}
+
+void scan_scalar(const char* data, std::size_t blocks, uint32_t base, scan_state& state, uint32_t*& out)
+{
+    block_masks m;
+    for (std::size_t b = 0; b < blocks; b++, data += 64, base += 64) {
+        classify_scalar(data, m);
+        validate_utf8_scalar(data, state);
+        out = flatten(structurals(m, state), base, out);
+    }
+}
+
+#ifdef JSON_SIMD_X86
+//* 结构字符和空白用两次 16 项查表分类: 低 4 位和高 4 位各查一次再按位与.
+//* bit0: { } [ ]   bit1: :   bit2: ,   bit3: \t \n \r   bit4: 空格
+#    define JSON_LO_NIBBLES 16, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 1, 4, 9, 0, 0
+#    define JSON_HI_NIBBLES 8, 0, 20, 2, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0
+
+__attribute__((target("sse4.2"))) void scan_sse42(const char* data, std::size_t blocks, uint32_t base, scan_state& state, uint32_t*& out)
+{
+    const __m128i lo_table = _mm_setr_epi8(JSON_LO_NIBBLES);
+    const __m128i hi_table = _mm_setr_epi8(JSON_HI_NIBBLES);
+    const __m128i op_bits  = _mm_set1_epi8(7);
+    const __m128i ws_bits  = _mm_set1_epi8(24);
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i quote    = _mm_set1_epi8('"');
+    const __m128i slash    = _mm_set1_epi8('\\');
+    const __m128i zero     = _mm_setzero_si128();
+    const __m128i b1h      = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high));
+    const __m128i b1l      = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low));
+    const __m128i b2h      = _mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high));
+    const __m128i max_last = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+
+    __m128i prev_in         = _mm_insert_epi32(zero, int(state.utf8_prev), 3);
+    __m128i prev_incomplete = _mm_subs_epu8(prev_in, max_last);
+    __m128i error           = zero;
+
+    block_masks m;
+    for (std::size_t b = 0; b < blocks; b++, data += 64, base += 64) {
+        m = block_masks{0, 0, 0, 0};
+        __m128i chunk[4];
+        for (int i = 0; i < 4; i++) {
+            chunk[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+        }
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(chunk[0], chunk[1]), _mm_or_si128(chunk[2], chunk[3]))) == 0) {
+            error   = _mm_or_si128(error, prev_incomplete);
+            prev_in = chunk[3];
+        }
+        else {
+            for (int i = 0; i < 4; i++) {
+                __m128i prev1  = _mm_alignr_epi8(chunk[i], prev_in, 15);
+                __m128i prev2  = _mm_alignr_epi8(chunk[i], prev_in, 14);
+                __m128i prev3  = _mm_alignr_epi8(chunk[i], prev_in, 13);
+                __m128i sc     = _mm_and_si128(_mm_and_si128(_mm_shuffle_epi8(b1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_mask)),
+                                                              _mm_shuffle_epi8(b1l, _mm_and_si128(prev1, low_mask))),
+                                               _mm_shuffle_epi8(b2h, _mm_and_si128(_mm_srli_epi16(chunk[i], 4), low_mask)));
+                __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80))), _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80))));
+                error          = _mm_or_si128(error, _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8(char(0x80))), sc));
+                prev_in        = chunk[i];
+            }
+            prev_incomplete = _mm_subs_epu8(prev_in, max_last);
+        }
+        for (int i = 0; i < 4; i++) {
+            __m128i  in    = chunk[i];
+            __m128i  lo    = _mm_shuffle_epi8(lo_table, _mm_and_si128(in, low_mask));
+            __m128i  hi    = _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(in, 4), low_mask));
+            __m128i  cls   = _mm_and_si128(lo, hi);
+            uint64_t shift = 16 * i;
+            m.quote |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(in, quote)))) << shift;
+            m.backslash |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(in, slash)))) << shift;
+            m.op |= uint64_t(uint16_t(~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(cls, op_bits), zero)))) << shift;
+            m.ws |= uint64_t(uint16_t(~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(cls, ws_bits), zero)))) << shift;
+        }
+        out = flatten(structurals(m, state), base, out);
+    }
+    state.utf8_error |= !_mm_testz_si128(error, error);
+    state.utf8_prev = uint32_t(_mm_extract_epi32(prev_in, 3));
+}
+
+__attribute__((target("avx2"))) void scan_avx2(const char* data, std::size_t blocks, uint32_t base, scan_state& state, uint32_t*& out)
+{
+    const __m256i lo_table = _mm256_setr_epi8(JSON_LO_NIBBLES, JSON_LO_NIBBLES);
+    const __m256i hi_table = _mm256_setr_epi8(JSON_HI_NIBBLES, JSON_HI_NIBBLES);
+    const __m256i op_bits  = _mm256_set1_epi8(7);
+    const __m256i ws_bits  = _mm256_set1_epi8(24);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i quote    = _mm256_set1_epi8('"');
+    const __m256i slash    = _mm256_set1_epi8('\\');
+    const __m256i zero     = _mm256_setzero_si256();
+    const __m256i b1h      = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high)));
+    const __m256i b1l      = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low)));
+    const __m256i b2h      = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high)));
+    const __m256i max_last = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                              -1, char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+
+    __m256i prev_in         = _mm256_insert_epi32(zero, int(state.utf8_prev), 7);
+    __m256i prev_incomplete = _mm256_subs_epu8(prev_in, max_last);
+    __m256i error           = zero;
+
+    block_masks m;
+    for (std::size_t b = 0; b < blocks; b++, data += 64, base += 64) {
+        uint64_t q = 0, s = 0, op = 0, ws = 0;
+        __m256i  chunk[2];
+        chunk[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        chunk[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+        if (_mm256_movemask_epi8(_mm256_or_si256(chunk[0], chunk[1])) == 0) {
+            error   = _mm256_or_si256(error, prev_incomplete);
+            prev_in = chunk[1];
+        }
+        else {
+            for (int half = 0; half < 2; half++) {
+                __m256i in     = chunk[half];
+                __m256i shifted = _mm256_permute2x128_si256(prev_in, in, 0x21);
+                __m256i prev1  = _mm256_alignr_epi8(in, shifted, 15);
+                __m256i prev2  = _mm256_alignr_epi8(in, shifted, 14);
+                __m256i prev3  = _mm256_alignr_epi8(in, shifted, 13);
+                __m256i sc     = _mm256_and_si256(_mm256_and_si256(_mm256_shuffle_epi8(b1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_mask)),
+                                                                   _mm256_shuffle_epi8(b1l, _mm256_and_si256(prev1, low_mask))),
+                                                  _mm256_shuffle_epi8(b2h, _mm256_and_si256(_mm256_srli_epi16(in, 4), low_mask)));
+                __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80))),
+                                                 _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80))));
+                error          = _mm256_or_si256(error, _mm256_xor_si256(_mm256_and_si256(must23, _mm256_set1_epi8(char(0x80))), sc));
+                prev_in        = in;
+            }
+            prev_incomplete = _mm256_subs_epu8(prev_in, max_last);
+        }
+        for (int half = 0; half < 2; half++) {
+            __m256i  in    = chunk[half];
+            __m256i  lo    = _mm256_shuffle_epi8(lo_table, _mm256_and_si256(in, low_mask));
+            __m256i  hi    = _mm256_shuffle_epi8(hi_table, _mm256_and_si256(_mm256_srli_epi16(in, 4), low_mask));
+            __m256i  cls   = _mm256_and_si256(lo, hi);
+            uint64_t shift = 32 * half;
+            q |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in, quote)))) << shift;
+            s |= uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(in, slash)))) << shift;
+            op |= uint64_t(uint32_t(~_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(cls, op_bits), zero)))) << shift;
+            ws |= uint64_t(uint32_t(~_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(cls, ws_bits), zero)))) << shift;
+        }
+        m.quote     = q;
+        m.backslash = s;
+        m.op        = op;
+        m.ws        = ws;
+        out = flatten(structurals(m, state), base, out);
+    }
+    state.utf8_error |= !_mm256_testz_si256(error, error);
+    state.utf8_prev = uint32_t(_mm256_extract_epi32(prev_in, 7));
+}
+#endif
+
+inline bool string_special(char c)
+{
+    return c == '"' || c == '\\' || uint8_t(c) < 0x20;
+}
+
+//* 一次检查 8 个字节(SWAR): 每个命中的字节最高位置 1. 借位只会在真正命中的字节之上产生误报,
+//* 所以最低的命中位总是准确的
+inline uint64_t string_special_mask(uint64_t x)
+{
+    constexpr uint64_t ones  = 0x0101010101010101ULL;
+    constexpr uint64_t highs = 0x8080808080808080ULL;
+    uint64_t           q     = x ^ (ones * '"');
+    uint64_t           b     = x ^ (ones * '\\');
+    return (((x - ones * 0x20) & ~x) | ((q - ones) & ~q) | ((b - ones) & ~b)) & highs;
+}
+
+const char* find_string_special_scalar(const char* p, const char* end)
+{
+    const char* begin = p;
+    uint64_t    x;
+    for (; p + 8 <= end; p += 8) {
+        std::memcpy(&x, p, sizeof(x));
+        uint64_t mask = string_special_mask(x);
+        if (mask != 0) {
+            return p + __builtin_ctzll(mask) / 8;
+        }
+    }
+    if (p < end && end - begin >= 8) {
+        //* 剩下不足 8 字节时和前面重叠着再读一组, 屏蔽掉已经检查过的字节
+        const char* last = end - 8;
+        std::memcpy(&x, last, sizeof(x));
+        uint64_t mask = string_special_mask(x) & (~0ULL << ((p - last) * 8));
+        return mask != 0 ? last + __builtin_ctzll(mask) / 8 : end;
+    }
+    while (p < end && !string_special(*p)) {
+        p++;
+    }
+    return p;
+}
+
+#ifdef JSON_SIMD_X86
+//* 每次看 16 字节, 只用到 SSE2 指令. 强制内联到调用者里, 这样在 avx2 函数中会被编码成 VEX 指令,
+//* 不会在 ymm 高位未清零时执行传统 SSE 指令而触发状态切换的惩罚
+__attribute__((always_inline)) inline const char* find_string_special_16(const char* p, const char* end)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+    const __m128i ctrl  = _mm_set1_epi8(0x1F);
+    for (; p + 16 <= end; p += 16) {
+        __m128i in   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hit  = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(in, quote), _mm_cmpeq_epi8(in, slash)), _mm_cmpeq_epi8(_mm_min_epu8(in, ctrl), in));
+        int     mask = _mm_movemask_epi8(hit);
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_string_special_scalar(p, end);
+}
+
+__attribute__((target("sse4.2"))) const char* find_string_special_sse42(const char* p, const char* end)
+{
+    return find_string_special_16(p, end);
+}
+
+__attribute__((target("avx2"))) const char* find_string_special_avx2(const char* p, const char* end)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    const __m256i ctrl  = _mm256_set1_epi8(0x1F);
+    for (; p + 32 <= end; p += 32) {
+        __m256i  in   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i  hit  = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(in, quote), _mm256_cmpeq_epi8(in, slash)),
+                                        _mm256_cmpeq_epi8(_mm256_min_epu8(in, ctrl), in));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(hit));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+    return find_string_special_16(p, end);
+}
+#endif
+
+using scan_fn = void (*)(const char*, std::size_t, uint32_t, scan_state&, uint32_t*&);
+
+using find_fn = const char* (*)(const char*, const char*);
+
+struct scan_impl {
+    scan_fn     fn;
+    find_fn     find_string_special;
+    const char* name;
+};
+
+scan_impl pick_impl()
+{
+#ifdef JSON_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {scan_avx2, find_string_special_avx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return {scan_sse42, find_string_special_sse42, "sse4.2"};
+    }
+#endif
+    return {scan_scalar, find_string_special_scalar, "scalar"};
+}
+
+const scan_impl& impl()
+{
+    static const scan_impl selected = pick_impl();
+    return selected;
+}
+
+}  // namespace
+
+// class json_structural_scanner
+std::size_t json_structural_scanner::scan(const char* data, std::size_t size, uint32_t* out)
+{
+    uint32_t*   p      = out;
+    std::size_t blocks = size / 64;
+    impl().fn(data, blocks, 0, state, p);
+    std::size_t rest = size % 64;
+    if (rest != 0) {
+        //* 最后不足 64 字节的部分用空格补齐, 空白不会产生结构位置
+        char tail[64];
+        std::memset(tail, ' ', sizeof(tail));
+        std::memcpy(tail, data + blocks * 64, rest);
+        impl().fn(tail, 1, static_cast<uint32_t>(blocks * 64), state, p);
+    }
+    return p - out;
+}
+void json_structural_scanner::finish()
+{
+    state.utf8_error |= utf8_incomplete(state.utf8_prev);
+}
+const char* json_structural_scanner::implementation()
+{
+    return impl().name;
+}
+// class json_structural_scanner
+
+const char* json::find_string_special(const char* p, const char* end)
+{
+    //* 短字符串很常见, 不足 32 字节的直接按 8 字节一组找, 不值得走向量化的路径
+    if (end - p < 32) {
+        return find_string_special_scalar(p, end);
+    }
+    return impl().find_string_special(p, end);
+}
+bool json::validate_utf8(const char* p, std::size_t size)
+{
+    const uint8_t* s   = reinterpret_cast<const uint8_t*>(p);
+    const uint8_t* end = s + size;
+    while (s < end) {
+        //* ASCII 一次跳过 8 字节
+        if (end - s >= 8) {
+            uint64_t x;
+            std::memcpy(&x, s, sizeof(x));
+            if ((x & 0x8080808080808080ULL) == 0) {
+                s += 8;
+                continue;
+            }
+        }
+        uint8_t c = *s;
+        if (c < 0x80) {
+            s++;
+            continue;
+        }
+        //* 首字节决定长度以及第二个字节的合法范围(排除过长编码、代理项和超过 U+10FFFF 的码点)
+        int     len;
+        uint8_t lo = 0x80, hi = 0xBF;
+        if (c >= 0xC2 && c <= 0xDF) {
+            len = 2;
+        } else if (c >= 0xE0 && c <= 0xEF) {
+            len = 3;
+            lo  = c == 0xE0 ? 0xA0 : 0x80;
+            hi  = c == 0xED ? 0x9F : 0xBF;
+        } else if (c >= 0xF0 && c <= 0xF4) {
+            len = 4;
+            lo  = c == 0xF0 ? 0x90 : 0x80;
+            hi  = c == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            return false;
+        }
+        if (end - s < len || s[1] < lo || s[1] > hi) {
+            return false;
+        }
+        for (int i = 2; i < len; i++) {
+            if ((s[i] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        s += len;
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace json {
+
+//* stage 1 扫描器: 一次处理 64 字节, 用 SIMD 比较得到引号、反斜杠、结构字符和空白的位掩码,
+//* 再用整数运算排除转义引号和字符串内部, 输出结构位置: { } [ ] : , 字符串的起始引号,
+//* 以及数字/true/false/null 的第一个字符. 解析器只需要按下标跳转, 不再逐字节跳过空白.
+//* 同一趟扫描顺带校验整个输入是合法的 UTF-8
+class json_structural_scanner {
+  public:
+    static constexpr std::size_t padding = 64;
+
+    //* 跨 64 字节块保留的状态
+    struct scan_state {
+        uint64_t in_string = 0;  // 上一块结束时是否在字符串里(全 0 或全 1)
+        uint64_t escaped   = 0;  // 上一块是否以奇数个反斜杠结束
+        uint64_t scalar    = 0;  // 上一块最后一个字节是否属于标量
+        uint32_t utf8_prev  = 0;  // 上一块最后 4 个字节, 最后一个字节在最高位
+        uint32_t utf8_error = 0;  // 至今是否遇到过非法 UTF-8
+    };
+
+    //* 把 [data, data + size) 中结构字符相对 data 的偏移写入 out, 返回个数.
+    //* out 至少要有 size + padding 项. 多次调用时输入必须首尾相接, 并且除最后一次外 size 都必须是 64 的倍数
+    std::size_t scan(const char* data, std::size_t size, uint32_t* out);
+    //* 输入全部送完之后调用, 检查结尾是否截断了一个多字节字符
+    void finish();
+    //* 扫描过的输入是否都是合法的 UTF-8
+    bool utf8_valid() const
+    {
+        return state.utf8_error == 0;
+    }
+    //* 到目前为止的输入是否停在一个未闭合的字符串里
+    bool in_string() const
+    {
+        return state.in_string != 0;
+    }
+    void reset()
+    {
+        state = scan_state();
+    }
+
+    //* 运行时选中的实现: "avx2", "sse4.2" 或 "scalar"
+    static const char* implementation();
+
+  private:
+    scan_state state;
+};  // class json_structural_scanner
+
+//* 返回 [p, end) 中第一个 '"'、'\\' 或控制字符(< 0x20)的位置, 没有则返回 end.
+//* 字符串里这三类之外的字节都可以原样整段拷贝
+const char* find_string_special(const char* p, const char* end);
+
+//* 单独校验一段字节是否是合法的 UTF-8, 给不经过 stage 1 的输入(例如流式解析)使用
+bool validate_utf8(const char* p, std::size_t size);
+
+}  // namespace json
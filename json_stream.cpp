@@ -0,0 +1,284 @@
+#include "json_stream.hpp"
+
+using namespace json;
+
+namespace {
+
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+//* 标量之后必须紧跟空白、结构字符或者输入结尾
+inline bool is_delimiter(const char* p, const char* end)
+{
+    if (p == end || is_space(*p)) {
+        return true;
+    }
+    switch (*p) {
+        case ',':
+        case ':':
+        case ']':
+        case '}':
+        case '[':
+        case '{':
+        case '"': return true;
+        default: return false;
+    }
+}
+
+inline bool is_number_char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+}  // namespace
+
+// class json_stream_parser
+json_stream_parser::json_stream_parser(json_sax_handler& handler) : handler(handler) {}
+bool json_stream_parser::feed(const char* data, std::size_t size)
+{
+    if (stopped) {
+        return false;
+    }
+    if (buffer.empty()) {
+        //* 没有遗留的半个 token 时直接在调用者的内存上解析, 只拷贝末尾不完整的部分
+        window           = data;
+        const char* rest = drain(data, data + size, false);
+        consumed += rest - data;
+        buffer.assign(rest, data + size);
+    } else {
+        buffer.append(data, size);
+        window           = buffer.data();
+        const char* rest = drain(buffer.data(), buffer.data() + buffer.size(), false);
+        consumed += rest - buffer.data();
+        buffer.erase(0, rest - buffer.data());
+    }
+    return !stopped;
+}
+bool json_stream_parser::finish()
+{
+    if (stopped) {
+        return false;
+    }
+    window           = buffer.data();
+    const char* rest = drain(buffer.data(), buffer.data() + buffer.size(), true);
+    if (stopped) {
+        return false;
+    }
+    if (rest != buffer.data() + buffer.size()) {
+        fail(rest, *rest == '"' ? "Unterminated string" : "Unexpected end of document.");
+    }
+    try {
+        grammar.end_document();
+    } catch (const json_parse_error& e) {
+        fail(rest, e.message());
+    }
+    consumed += buffer.size();
+    buffer.clear();
+    return true;
+}
+void json_stream_parser::stop()
+{
+    stopped = true;
+}
+void json_stream_parser::fail(const char* at, const std::string& message) const
+{
+    throw json_parse_error(message, consumed + (at - window));
+}
+const char* json_stream_parser::drain(const char* p, const char* end, bool last)
+{
+    while (true) {
+        while (p < end && is_space(*p)) {
+            p++;
+        }
+        if (p == end) {
+            return p;
+        }
+        //* 状态机不知道位置, 它报的错都在当前 token 的开头
+        try {
+            switch (*p) {
+                case '{':
+                    grammar.begin_object();
+                    p++;
+                    if (!handler.on_begin_object()) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                case '}':
+                    grammar.end_object();
+                    p++;
+                    if (!handler.on_end_object()) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                case '[':
+                    grammar.begin_array();
+                    p++;
+                    if (!handler.on_begin_array()) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                case ']':
+                    grammar.end_array();
+                    p++;
+                    if (!handler.on_end_array()) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                case ':':
+                    grammar.colon();
+                    p++;
+                    continue;
+                case ',':
+                    grammar.comma();
+                    p++;
+                    continue;
+                case '"': {
+                    const char* close = find_string_end(p, end);
+                    if (close == nullptr) {
+                        return p;
+                    }
+                    std::string_view s      = decode_string(p + 1, close);
+                    bool             is_key = grammar.string_is_key();
+                    p                       = close + 1;
+                    if (!(is_key ? handler.on_key(s) : handler.on_string(s))) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                }
+                case 't':
+                case 'f':
+                case 'n': {
+                    std::string_view literal = *p == 't' ? "true" : *p == 'f' ? "false" : "null";
+                    std::size_t      avail   = end - p;
+                    std::size_t      n       = std::min(avail, literal.size());
+                    if (std::string_view(p, n) != literal.substr(0, n)) {
+                        fail(p, *p == 'n' ? "Invalid null" : "Invalid boolean");
+                    }
+                    //* 还要看到字面量之后的一个字节才能确认它已经结束
+                    if (avail < literal.size() + (last ? 0 : 1)) {
+                        if (!last) {
+                            return p;
+                        }
+                        fail(p, *p == 'n' ? "Invalid null" : "Invalid boolean");
+                    }
+                    if (!is_delimiter(p + literal.size(), end)) {
+                        fail(p + literal.size(), fmt::format("Unexpected json char : {}", p[literal.size()]));
+                    }
+                    bool ok;
+                    if (*p == 'n') {
+                        grammar.value(NULL_VALUE);
+                        ok = handler.on_null();
+                    } else {
+                        grammar.value(BOOLEAN);
+                        ok = handler.on_boolean(*p == 't');
+                    }
+                    p += literal.size();
+                    if (!ok) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                }
+                case '-':
+                case '0':
+                case '1':
+                case '2':
+                case '3':
+                case '4':
+                case '5':
+                case '6':
+                case '7':
+                case '8':
+                case '9': {
+                    //* 数字没有结束符, 必须看到后面的分隔符(或者输入结束)才能确定它完整
+                    const char* q = p;
+                    while (q < end && is_number_char(*q)) {
+                        q++;
+                    }
+                    if (q == end && !last) {
+                        return p;
+                    }
+                    grammar.value(NUMBER);
+                    json_number n;
+                    const char* e;
+                    try {
+                        e = parse_number(p, q, n);
+                    } catch (const std::runtime_error& error) {
+                        fail(p, error.what());
+                    }
+                    if (!is_delimiter(e, end)) {
+                        fail(e, fmt::format("Unexpected json char : {}", *e));
+                    }
+                    p = e;
+                    if (!handler.on_number(n)) {
+                        stop();
+                        return end;
+                    }
+                    continue;
+                }
+                default: fail(p, fmt::format("Unexpected json char : {}", *p));
+            }
+        } catch (const json_parse_error& e) {
+            if (e.offset() != json_parse_error::npos) {
+                throw;
+            }
+            fail(p, e.message());
+        }
+    }
+}
+const char* json_stream_parser::find_string_end(const char* open, const char* end)
+{
+    const char* p = string_resume != 0 ? open + string_resume : open + 1;
+    while (true) {
+        p = find_string_special(p, end);
+        if (p == end) {
+            string_resume = p - open;
+            return nullptr;
+        }
+        if (*p == '"') {
+            string_resume = 0;
+            return p;
+        }
+        if (*p != '\\') {
+            fail(p, fmt::format("Unescaped control character in string : {:#04x}", int(uint8_t(*p))));
+        }
+        //* 反斜杠和被转义的字符必须一起看到, 否则下次从反斜杠重新开始
+        if (end - p < 2) {
+            string_resume = p - open;
+            return nullptr;
+        }
+        string_escaped = true;
+        p += 2;
+    }
+}
+std::string_view json_stream_parser::decode_string(const char* begin, const char* end)
+{
+    if (!validate_utf8(begin, end - begin)) {
+        fail(find_invalid_utf8(begin, end), "Invalid UTF-8 in json input");
+    }
+    if (!string_escaped) {
+        return std::string_view(begin, end - begin);
+    }
+    string_escaped  = false;
+    const char* p   = find_string_special(begin, end);
+    scratch.assign(begin, p);
+    while (p < end) {
+        try {
+            p = decode_escape(p, end, scratch);
+        } catch (const json_parse_error& e) {
+            fail(p, e.message());
+        }
+        const char* run = find_string_special(p, end);
+        scratch.append(p, run);
+        p = run;
+    }
+    return scratch;
+}
+// class json_stream_parser
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "json_sax.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace json {
+
+//* 增量解析: 输入可以在任意位置切成多段陆续送入, 包括 token、字符串和转义序列的中间.
+//* 每段送入后, 已经完整的 token 立即变成事件推给 handler; 不完整的尾巴留在内部缓冲区,
+//* 语法状态和容器栈保存在 json_grammar 里, 下一段到来时接着处理.
+//* 配合 json_document_builder 使用时, done() 一返回 true 文档就可以使用
+class json_stream_parser {
+  public:
+    explicit json_stream_parser(json_sax_handler& handler);
+
+    //* 送入下一段输入. handler 要求停止时返回 false, 之后的输入都被忽略
+    bool feed(const char* data, std::size_t size);
+    bool feed(std::string_view chunk)
+    {
+        return feed(chunk.data(), chunk.size());
+    }
+    //* 输入结束: 处理末尾还在等分隔符的数字, 文档不完整时抛出异常
+    bool finish();
+    //* 格式错误时 feed 和 finish 抛出 json_parse_error, 位置从送入的第一个字节算起
+
+    //* 顶层值已经完整
+    bool done() const
+    {
+        return grammar.complete();
+    }
+    //* 容器最多嵌套多少层, 超过时在那个 '[' 或 '{' 处抛出 json_parse_error, 默认 json_grammar::default_max_depth.
+    //* 只影响之后开始的容器
+    void set_max_depth(std::size_t depth)
+    {
+        grammar.set_max_depth(depth);
+    }
+    //* 缓冲区里等待后续输入的字节数
+    std::size_t pending() const
+    {
+        return buffer.size();
+    }
+
+  private:
+    //* 处理 [p, end) 中所有完整的 token, 返回第一个未处理字节的位置.
+    //* last 为 true 表示之后不会再有输入, 结尾的数字不必再等分隔符
+    const char* drain(const char* p, const char* end, bool last);
+    //* 找 open 处开始的字符串的结束引号, 输入不够时记下扫描进度并返回 nullptr
+    const char* find_string_end(const char* open, const char* end);
+    //* 字符串内容 [begin, end) 解码后的视图
+    std::string_view decode_string(const char* begin, const char* end);
+    void             stop();
+    //* 在当前处理的输入中的 at 处报错
+    [[noreturn]] void fail(const char* at, const std::string& message) const;
+
+    json_sax_handler& handler;
+    json_grammar      grammar;
+    std::string       buffer;                    // 上一段输入末尾不完整的 token
+    std::string       scratch;                   // 带转义的字符串解码到这里
+    const char*       window         = nullptr;  // 当前处理的输入的起点, 送入的数据或者 buffer
+    std::size_t       consumed       = 0;        // window 之前的输入字节数
+    std::size_t       string_resume  = 0;        // 不完整的字符串已经扫描到相对 token 起点的偏移
+    bool              string_escaped = false;    // 当前字符串里出现过转义
+    bool              stopped        = false;
+};  // class json_stream_parser
+
+}  // namespace json
@@ -0,0 +1,284 @@
+#include "json_tape.hpp"
+#include "json_sax.hpp"
+#include "json_writer.hpp"
+
+using namespace json;
+
+// class json_tape_view
+std::size_t json_tape_view::size() const
+{
+    tape_tag t = tag();
+    if (t != TAPE_BEGIN_OBJECT && t != TAPE_BEGIN_ARRAY) {
+        throw std::runtime_error("json tape size error : not a container.");
+    }
+    std::size_t count = (payload(index) >> 32) & 0xFFFFFF;
+    if (count < 0xFFFFFF) {
+        return count;
+    }
+    //* 计数溢出时逐个数
+    count          = 0;
+    uint32_t end   = static_cast<uint32_t>(payload(index)) - 1;
+    uint32_t child = index + 1;
+    while (child < end) {
+        child = skip(t == TAPE_BEGIN_OBJECT ? child + 1 : child);
+        count++;
+    }
+    return count;
+}
+std::string_view json_tape_view::get_string() const
+{
+    if (tag() != TAPE_STRING) {
+        throw std::runtime_error("json tape access error : not a string.");
+    }
+    return string_at(index);
+}
+double json_tape_view::get_number() const
+{
+    switch (tag()) {
+        case TAPE_INT64: return static_cast<double>(static_cast<int64_t>(words[index + 1]));
+        case TAPE_UINT64: return static_cast<double>(words[index + 1]);
+        case TAPE_DOUBLE: {
+            double d;
+            std::memcpy(&d, &words[index + 1], sizeof(d));
+            return d;
+        }
+        default: throw std::runtime_error("json tape access error : not a number.");
+    }
+}
+int64_t json_tape_view::get_int64() const
+{
+    if (tag() != TAPE_INT64) {
+        throw std::runtime_error("json tape access error : not an int64.");
+    }
+    return static_cast<int64_t>(words[index + 1]);
+}
+uint64_t json_tape_view::get_uint64() const
+{
+    tape_tag t = tag();
+    if (t == TAPE_UINT64 || (t == TAPE_INT64 && static_cast<int64_t>(words[index + 1]) >= 0)) {
+        return words[index + 1];
+    }
+    throw std::runtime_error("json tape access error : not an uint64.");
+}
+bool json_tape_view::get_boolean() const
+{
+    tape_tag t = tag();
+    if (t != TAPE_TRUE && t != TAPE_FALSE) {
+        throw std::runtime_error("json tape access error : not a boolean.");
+    }
+    return t == TAPE_TRUE;
+}
+bool json_tape_view::is_null() const
+{
+    return tag() == TAPE_NULL;
+}
+json_tape_view json_tape_view::operator[](std::string_view key) const
+{
+    if (tag() != TAPE_BEGIN_OBJECT) {
+        throw std::runtime_error("json access object error.");
+    }
+    uint32_t i = index + 1;
+    while (static_cast<tape_tag>(words[i] >> 56) != TAPE_END_OBJECT) {
+        if (string_at(i) == key) {
+            return json_tape_view(words, strings, i + 1);
+        }
+        i = skip(i + 1);
+    }
+    throw std::runtime_error("json access object error : key not found");
+}
+json_tape_view json_tape_view::operator[](std::size_t n) const
+{
+    if (tag() != TAPE_BEGIN_ARRAY) {
+        throw std::runtime_error("json access arrary error.");
+    }
+    uint32_t i = index + 1;
+    while (static_cast<tape_tag>(words[i] >> 56) != TAPE_END_ARRAY) {
+        if (n-- == 0) {
+            return json_tape_view(words, strings, i);
+        }
+        i = skip(i);
+    }
+    throw std::runtime_error("json access array error : index out of range");
+}
+uint32_t json_tape_view::skip(uint32_t i) const
+{
+    switch (static_cast<tape_tag>(words[i] >> 56)) {
+        case TAPE_BEGIN_OBJECT:
+        case TAPE_BEGIN_ARRAY: return static_cast<uint32_t>(payload(i));
+        case TAPE_DOUBLE:
+        case TAPE_INT64:
+        case TAPE_UINT64: return i + 2;
+        default: return i + 1;
+    }
+}
+std::string_view json_tape_view::string_at(uint32_t i) const
+{
+    const char* p = strings + payload(i);
+    uint32_t    len;
+    std::memcpy(&len, p, sizeof(len));
+    return std::string_view(p + sizeof(len), len);
+}
+std::string json_tape_view::to_string(int indent) const
+{
+    std::string ret;
+    {
+        json_writer writer(ret, indent);
+        write(writer);
+    }
+    return ret;
+}
+void json_tape_view::write(json_writer& writer) const
+{
+    //* 顺序扫描 tape, 栈里只记录每层容器的状态: 0 数组, 1 对象里等待键, 2 对象里等待值
+    std::vector<uint8_t> state;
+    uint32_t             i   = index;
+    uint32_t             end = skip(index);
+    while (i < end) {
+        tape_tag t = static_cast<tape_tag>(words[i] >> 56);
+        if (t == TAPE_END_OBJECT || t == TAPE_END_ARRAY) {
+            t == TAPE_END_OBJECT ? writer.end_object() : writer.end_array();
+            state.pop_back();
+            i++;
+            continue;
+        }
+        if (!state.empty() && state.back() != 0) {
+            if (state.back() == 1) {
+                writer.key(string_at(i));
+                state.back() = 2;
+                i++;
+                continue;
+            }
+            state.back() = 1;
+        }
+        switch (t) {
+            case TAPE_BEGIN_OBJECT:
+                writer.begin_object();
+                state.push_back(1);
+                i++;
+                continue;
+            case TAPE_BEGIN_ARRAY:
+                writer.begin_array();
+                state.push_back(0);
+                i++;
+                continue;
+            case TAPE_STRING: writer.string(string_at(i)); break;
+            case TAPE_DOUBLE: writer.number(json_tape_view(words, strings, i).get_number()); break;
+            case TAPE_INT64: writer.number(static_cast<int64_t>(words[i + 1])); break;
+            case TAPE_UINT64: writer.number(words[i + 1]); break;
+            case TAPE_TRUE: writer.boolean(true); break;
+            case TAPE_FALSE: writer.boolean(false); break;
+            case TAPE_NULL: writer.null(); break;
+            default: throw std::runtime_error("json to string error.");
+        }
+        i = skip(i);
+    }
+}
+// class json_tape_view
+
+// class json_tape
+json_tape_view json_tape::root() const
+{
+    if (words.empty()) {
+        throw std::runtime_error("json document is empty.");
+    }
+    return json_tape_view(words.data(), strings.data(), 0);
+}
+json_tape_view json_tape::operator[](std::string_view key) const
+{
+    return root()[key];
+}
+json_tape_view json_tape::operator[](std::size_t index) const
+{
+    return root()[index];
+}
+std::string json_tape::to_string(int indent) const
+{
+    return root().to_string(indent);
+}
+// class json_tape
+
+class json_parser::tape_builder {
+  public:
+    explicit tape_builder(json_tape& tape) : tape(tape) {}
+
+    bool on_begin_object()
+    {
+        return begin(TAPE_BEGIN_OBJECT);
+    }
+    bool on_begin_array()
+    {
+        return begin(TAPE_BEGIN_ARRAY);
+    }
+    bool on_end_object()
+    {
+        return end(TAPE_END_OBJECT);
+    }
+    bool on_end_array()
+    {
+        return end(TAPE_END_ARRAY);
+    }
+    bool on_key(std::string_view k)
+    {
+        tape.append_string(k);
+        return true;
+    }
+    bool on_string(std::string_view s)
+    {
+        counted();
+        tape.append_string(s);
+        return true;
+    }
+    bool on_number(const json_number& n)
+    {
+        counted();
+        tape.append_number(n);
+        return true;
+    }
+    bool on_boolean(bool b)
+    {
+        counted();
+        tape.append(b ? TAPE_TRUE : TAPE_FALSE, 0);
+        return true;
+    }
+    bool on_null()
+    {
+        counted();
+        tape.append(TAPE_NULL, 0);
+        return true;
+    }
+
+  private:
+    //* 父容器的直接子元素加一
+    void counted()
+    {
+        if (!count.empty()) {
+            count.back()++;
+        }
+    }
+    bool begin(tape_tag tag)
+    {
+        counted();
+        open.push_back(tape.append(tag, 0));
+        count.push_back(0);
+        return true;
+    }
+    bool end(tape_tag tag)
+    {
+        tape.close(open.back(), tag, std::min<uint32_t>(count.back(), 0xFFFFFF));
+        open.pop_back();
+        count.pop_back();
+        return true;
+    }
+
+    json_tape&            tape;
+    std::vector<uint32_t> open;   // 尚未闭合的容器在 tape 上的下标
+    std::vector<uint32_t> count;  // 对应容器已有的直接子元素个数
+};  // class json_parser::tape_builder
+
+json_tape json_parser::parse_tape()
+{
+    json_tape    tape;
+    tape_builder builder(tape);
+    parse(builder);
+    return tape;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "json_parser.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+class json_writer;
+
+//* tape 上每个 64 位条目的高 8 位是类型标签, 低 56 位是负载
+enum tape_tag : uint8_t {
+    TAPE_BEGIN_OBJECT = '{',  // 负载: 低 32 位为闭合 '}' 之后的下标, 高位为成员数
+    TAPE_END_OBJECT   = '}',  // 负载: 对应 '{' 的下标
+    TAPE_BEGIN_ARRAY  = '[',  // 负载: 低 32 位为闭合 ']' 之后的下标, 高位为元素数
+    TAPE_END_ARRAY    = ']',  // 负载: 对应 '[' 的下标
+    TAPE_STRING       = '"',  // 负载: 字符串缓冲区中的偏移, 该处先存 uint32 长度再存字节
+    TAPE_DOUBLE       = 'd',  // 下一个条目是 double 的原始位
+    TAPE_INT64        = 'l',  // 下一个条目是 int64_t
+    TAPE_UINT64       = 'u',  // 下一个条目是 uint64_t
+    TAPE_TRUE         = 't',
+    TAPE_FALSE        = 'f',
+    TAPE_NULL         = 'n'
+};
+
+//* 指向 tape 中某个值的轻量视图, 只保存两个指针和一个下标, 可以随意拷贝
+class json_tape_view {
+  public:
+    json_tape_view(const uint64_t* words, const char* strings, uint32_t index) : words(words), strings(strings), index(index) {}
+
+    tape_tag tag() const
+    {
+        return static_cast<tape_tag>(words[index] >> 56);
+    }
+    //* 容器的元素个数(对象为成员数)
+    std::size_t size() const;
+
+    std::string_view get_string() const;
+    //* 任意数字都可以按 double 读取; 整数只有在对应类型范围内时才能按整数读取
+    double           get_number() const;
+    int64_t          get_int64() const;
+    uint64_t         get_uint64() const;
+    bool             get_boolean() const;
+    bool             is_null() const;
+
+    json_tape_view operator[](std::string_view key) const;
+    json_tape_view operator[](std::size_t index) const;
+
+    std::string to_string(int indent = 0) const;
+    //* 把这个值顺序写给 writer, 不递归
+    void write(json_writer& writer) const;
+
+  private:
+    uint64_t payload(uint32_t i) const
+    {
+        return words[i] & ((uint64_t(1) << 56) - 1);
+    }
+    //* 跳过下标 i 处的整个值, 返回下一个兄弟节点的下标
+    uint32_t         skip(uint32_t i) const;
+    std::string_view string_at(uint32_t i) const;
+
+    const uint64_t* words;
+    const char*     strings;
+    uint32_t        index;
+};  // class json_tape_view
+
+//* 扁平的 tape 文档: 所有节点连续存放在一个 uint64 数组里, 字符串放在单独的缓冲区
+class json_tape {
+  public:
+    friend class json_parser;
+    friend class json_tape_cache;
+
+    json_tape_view root() const;
+
+    json_tape_view operator[](std::string_view key) const;
+    json_tape_view operator[](std::size_t index) const;
+
+    std::string to_string(int indent = 0) const;
+
+    //* tape 和字符串缓冲区占用的字节数
+    std::size_t footprint() const
+    {
+        return words.size() * sizeof(uint64_t) + strings.size();
+    }
+
+  private:
+    uint32_t append(tape_tag tag, uint64_t payload)
+    {
+        words.push_back((uint64_t(tag) << 56) | payload);
+        return static_cast<uint32_t>(words.size() - 1);
+    }
+    void append_number(const json_number& n)
+    {
+        uint64_t bits;
+        switch (n.type) {
+            case NUMBER_INT64: append(TAPE_INT64, 0); break;
+            case NUMBER_UINT64: append(TAPE_UINT64, 0); break;
+            default: append(TAPE_DOUBLE, 0); break;
+        }
+        std::memcpy(&bits, &n.u, sizeof(bits));
+        words.push_back(bits);
+    }
+    void append_string(std::string_view s)
+    {
+        uint32_t len = static_cast<uint32_t>(s.size());
+        append(TAPE_STRING, strings.size());
+        strings.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        strings.append(s.data(), s.size());
+    }
+    //* 闭合 open 处的容器, count 为其直接子元素个数
+    void close(uint32_t open, tape_tag tag, uint32_t count)
+    {
+        uint32_t end = append(tag, open);
+        words[open] |= (uint64_t(count) << 32) | (end + 1);
+    }
+
+    std::vector<uint64_t> words;
+    std::string           strings;
+};  // class json_tape
+
+}  // namespace json
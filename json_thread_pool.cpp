@@ -0,0 +1,118 @@
+#include "json_thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace json;
+
+// class json_thread_pool
+json_thread_pool::json_thread_pool(unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<queue>());
+    }
+    for (unsigned i = 0; i + 1 < threads; i++) {
+        workers.emplace_back(&json_thread_pool::worker, this, i);
+    }
+}
+json_thread_pool::~json_thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+void json_thread_pool::run(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+    if (count == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        job       = &task;
+        remaining = count;
+        error     = nullptr;
+        generation++;
+    }
+    //* 按连续区间分配: 第 i 个队列拿到 [count * i / n, count * (i + 1) / n)
+    std::size_t n = queues.size();
+    for (std::size_t i = 0; i < n; i++) {
+        std::lock_guard<std::mutex> guard(queues[i]->lock);
+        for (std::size_t k = count * i / n; k < count * (i + 1) / n; k++) {
+            queues[i]->tasks.push_back(k);
+        }
+    }
+    wake.notify_all();
+    drain(static_cast<unsigned>(n - 1));
+
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [this] { return remaining == 0; });
+    job = nullptr;
+    if (error) {
+        std::rethrow_exception(std::exchange(error, nullptr));
+    }
+}
+void json_thread_pool::worker(unsigned id)
+{
+    std::size_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        drain(id);
+    }
+}
+bool json_thread_pool::take(unsigned id, std::size_t& index)
+{
+    {
+        queue&                      own = *queues[id];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            index = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (std::size_t i = 1; i < queues.size(); i++) {
+        queue&                      victim = *queues[(id + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+void json_thread_pool::drain(unsigned id)
+{
+    std::size_t index;
+    while (take(id, index)) {
+        //* 取到任务说明这一批还没结束, job 一定指向当前这一批的函数
+        try {
+            (*job)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if (--remaining == 0) {
+            finished.notify_all();
+        }
+    }
+}
+// class json_thread_pool
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace json {
+
+//* 工作窃取线程池: 每个线程有自己的任务队列, 从队尾取自己的任务, 自己的队列空了就从别人的队头偷.
+//* 任务按连续的区间分给各个队列, 相邻的任务大多由同一个线程完成; 耗时不均时空闲的线程会把剩下的偷走.
+//* run() 阻塞到所有任务完成, 调用线程自己也参与执行
+class json_thread_pool {
+  public:
+    //* threads 为总线程数(包括调用 run() 的线程), 0 表示使用全部硬件线程
+    explicit json_thread_pool(unsigned threads = 0);
+    ~json_thread_pool();
+    json_thread_pool(const json_thread_pool&) = delete;
+    json_thread_pool& operator=(const json_thread_pool&) = delete;
+
+    unsigned size() const
+    {
+        return static_cast<unsigned>(queues.size());
+    }
+    //* 并行执行 task(0) .. task(count - 1). 任务抛出异常时其余任务照常执行, 结束后重新抛出第一个异常.
+    //* 同一时刻只能有一个线程调用 run()
+    void run(std::size_t count, const std::function<void(std::size_t)>& task);
+
+  private:
+    struct queue {
+        std::mutex              lock;
+        std::deque<std::size_t> tasks;
+    };
+
+    void worker(unsigned id);
+    //* 先从自己的队尾取, 再依次从其他队列的队头偷, 所有队列都空时返回 false
+    bool take(unsigned id, std::size_t& index);
+    //* 不断取任务执行直到取不到为止
+    void drain(unsigned id);
+
+    std::vector<std::unique_ptr<queue>>     queues;            // 最后一个属于调用 run() 的线程
+    std::vector<std::thread>                workers;
+    std::mutex                              lock;
+    std::condition_variable                 wake;              // 有新的一批任务, 或者要退出
+    std::condition_variable                 finished;          // 这一批任务全部完成
+    const std::function<void(std::size_t)>* job        = nullptr;
+    std::size_t                             generation = 0;    // 每次 run() 加一, 工作线程据此判断有没有新任务
+    std::size_t                             remaining  = 0;    // 这一批尚未完成的任务数
+    std::exception_ptr                      error;             // 这一批里第一个抛出的异常
+    bool                                    stopping   = false;
+};  // class json_thread_pool
+
+}  // namespace json
@@ -0,0 +1,235 @@
+#include "json_writer.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <fmt/compile.h>
+
+using namespace json;
+
+// class json_writer
+json_writer::json_writer(std::string& out, int indent) : out(&out), indent(indent) {}
+json_writer::json_writer(std::ostream& os, int indent) : out(&buffer), os(&os), indent(indent)
+{
+    buffer.reserve(flush_threshold + 4096);
+}
+json_writer::~json_writer()
+{
+    flush();
+}
+void json_writer::flush()
+{
+    if (os != nullptr && !out->empty()) {
+        os->write(out->data(), out->size());
+        out->clear();
+    }
+}
+void json_writer::prefix()
+{
+    maybe_flush();
+    if (after_key) {
+        after_key = false;
+        return;
+    }
+    if (need_comma) {
+        out->push_back(',');
+    }
+    if (depth > 0) {
+        newline();
+    }
+}
+void json_writer::newline()
+{
+    if (indent > 0) {
+        out->push_back('\n');
+        out->append(static_cast<std::size_t>(depth) * indent, ' ');
+    }
+}
+void json_writer::begin_object()
+{
+    prefix();
+    out->push_back('{');
+    depth++;
+    need_comma = false;
+}
+void json_writer::end_object()
+{
+    depth--;
+    if (need_comma) {
+        newline();
+    }
+    out->push_back('}');
+    need_comma = true;
+}
+void json_writer::begin_array()
+{
+    prefix();
+    out->push_back('[');
+    depth++;
+    need_comma = false;
+}
+void json_writer::end_array()
+{
+    depth--;
+    if (need_comma) {
+        newline();
+    }
+    out->push_back(']');
+    need_comma = true;
+}
+void json_writer::key(std::string_view k)
+{
+    prefix();
+    write_escaped(k);
+    out->push_back(':');
+    if (indent > 0) {
+        out->push_back(' ');
+    }
+    after_key = true;
+}
+void json_writer::string(std::string_view s)
+{
+    prefix();
+    write_escaped(s);
+    need_comma = true;
+}
+void json_writer::number(double d)
+{
+    prefix();
+    need_comma = true;
+    if (!std::isfinite(d)) {
+        out->append("null");
+        return;
+    }
+    //* fmt 的 "{}" 按最短往返表示输出(Dragonbox)
+    char  tmp[32];
+    char* end = fmt::format_to(tmp, FMT_COMPILE("{}"), d);
+    out->append(tmp, end);
+    if (std::string_view(tmp, end - tmp).find_first_of(".e") == std::string_view::npos) {
+        out->append(".0");
+    }
+}
+void json_writer::number(int64_t i)
+{
+    prefix();
+    need_comma = true;
+    char tmp[24];
+    out->append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), i).ptr);
+}
+void json_writer::number(uint64_t u)
+{
+    prefix();
+    need_comma = true;
+    char tmp[24];
+    out->append(tmp, std::to_chars(tmp, tmp + sizeof(tmp), u).ptr);
+}
+void json_writer::number(const json_number& n)
+{
+    switch (n.type) {
+        case NUMBER_INT64: number(n.i); break;
+        case NUMBER_UINT64: number(n.u); break;
+        default: number(n.d); break;
+    }
+}
+void json_writer::boolean(bool b)
+{
+    prefix();
+    need_comma = true;
+    out->append(b ? "true" : "false");
+}
+void json_writer::null()
+{
+    prefix();
+    need_comma = true;
+    out->append("null");
+}
+void json_writer::write_escaped(std::string_view s)
+{
+    static const char hex[] = "0123456789abcdef";
+    out->push_back('"');
+    const char* p   = s.data();
+    const char* end = p + s.size();
+    while (p < end) {
+        //* 不需要转义的片段整段追加
+        const char* q = find_string_special(p, end);
+        out->append(p, q);
+        if (q == end) {
+            break;
+        }
+        char c = *q;
+        switch (c) {
+            case '"': out->append("\\\""); break;
+            case '\\': out->append("\\\\"); break;
+            case '\b': out->append("\\b"); break;
+            case '\f': out->append("\\f"); break;
+            case '\n': out->append("\\n"); break;
+            case '\r': out->append("\\r"); break;
+            case '\t': out->append("\\t"); break;
+            default: {
+                char u[6] = {'\\', 'u', '0', '0', hex[(c >> 4) & 0xF], hex[c & 0xF]};
+                out->append(u, sizeof(u));
+            }
+        }
+        p = q + 1;
+    }
+    out->push_back('"');
+}
+void json_writer::write(const json_value& value)
+{
+    //* 用显式的栈代替递归, 嵌套多深都不会用完调用栈. 每层只记容器和下一个要写的成员
+    struct level {
+        const json_value* container;
+        std::size_t       next;
+    };
+    std::vector<level> stack;
+    const json_value*  current = &value;
+    while (true) {
+        const auto& v = current->json;
+        if (auto s = std::get_if<json_string>(&v)) {
+            string(*s);
+        } else if (auto d = std::get_if<double>(&v)) {
+            number(*d);
+        } else if (auto i = std::get_if<int64_t>(&v)) {
+            number(*i);
+        } else if (auto u = std::get_if<uint64_t>(&v)) {
+            number(*u);
+        } else if (auto b = std::get_if<bool>(&v)) {
+            boolean(*b);
+        } else if (std::holds_alternative<nullptr_t>(v)) {
+            null();
+        } else if (std::holds_alternative<json_array>(v)) {
+            begin_array();
+            stack.push_back(level{current, 0});
+        } else if (std::holds_alternative<json_object>(v)) {
+            begin_object();
+            stack.push_back(level{current, 0});
+        } else {
+            throw std::runtime_error("json to string error.");
+        }
+        //* 找下一个要写的值, 写完的容器依次闭合
+        current = nullptr;
+        while (current == nullptr && !stack.empty()) {
+            level& top = stack.back();
+            if (auto array = std::get_if<json_array>(&top.container->json)) {
+                if (top.next < array->size()) {
+                    current = (*array)[top.next++];
+                    continue;
+                }
+                end_array();
+            } else {
+                auto& object = std::get<json_object>(top.container->json);
+                if (top.next < object.size()) {
+                    const auto& member = *(object.begin() + top.next++);
+                    key(member.first);
+                    current = member.second;
+                    continue;
+                }
+                end_object();
+            }
+            stack.pop_back();
+        }
+        if (current == nullptr) {
+            return;
+        }
+    }
+}
+// class json_writer
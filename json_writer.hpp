@@ -0,0 +1,68 @@
+#pragma once
+
+#include "json_parser.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+//* 流式序列化器: 所有输出追加到同一个缓冲区, 由写入者自己处理逗号、冒号和缩进.
+//* 输出到 std::string 时直接追加到调用者的字符串; 输出到 std::ostream 时
+//* 先攒在内部缓冲区里, 超过 flush_threshold 再整段写出, 析构时写出剩余部分
+class json_writer {
+  public:
+    //* indent 为 0 时输出紧凑格式, 否则每层缩进 indent 个空格
+    explicit json_writer(std::string& out, int indent = 0);
+    explicit json_writer(std::ostream& os, int indent = 0);
+    ~json_writer();
+    json_writer(const json_writer&) = delete;
+    json_writer& operator=(const json_writer&) = delete;
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+    void key(std::string_view k);
+    void string(std::string_view s);
+    //* double 输出最短的能精确还原的表示, 整数值带上 ".0" 以免读回来变成整数; inf/nan 输出 null
+    void number(double d);
+    void number(int64_t i);
+    void number(uint64_t u);
+    void number(const json_number& n);
+    void boolean(bool b);
+    void null();
+
+    //* 写出整个节点; 用显式的栈遍历, 嵌套多深都不会用完调用栈
+    void write(const json_value& value);
+
+    //* 把缓冲区写到流里, 输出到 std::string 时什么也不做
+    void flush();
+
+  private:
+    //* 写值之前: 按需要补上逗号、换行和缩进
+    void prefix();
+    void newline();
+    void write_escaped(std::string_view s);
+    void maybe_flush()
+    {
+        if (os != nullptr && out->size() >= flush_threshold) {
+            flush();
+        }
+    }
+
+    static constexpr std::size_t flush_threshold = 64 * 1024;
+
+    std::string   buffer;  // 输出到流时使用的缓冲区
+    std::string*  out;
+    std::ostream* os         = nullptr;
+    int           indent     = 0;
+    int           depth      = 0;
+    bool          need_comma = false;  // 当前容器里已经写过元素
+    bool          after_key  = false;  // 刚写完键, 下一个值紧跟冒号
+};  // class json_writer
+
+}  // namespace json
@@ -0,0 +1,114 @@
+//* tape 缓存: 命中时直接映射; 缓存文件里的 tape 被改坏时必须重新解析, 而不是按坏的偏移去读
+//* make test 运行, 有失败的检查就返回非 0
+
+#include "../json_cache.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+using namespace json;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fmt::print("test_cache: FAILED {}\n", what);
+        failures++;
+    }
+}
+
+void check_values(const json_cached_tape& tape, const char* what)
+{
+    check(tape["name"].get_string() == "cache" && tape["list"].size() == 3 && tape["list"][2]["x"].get_int64() == -7 &&
+              tape["ok"].get_boolean(),
+          what);
+}
+
+//* 找到缓存文件里第 n 个标签为 tag 的 tape 条目, 用 change 改写它. tape 紧跟在头部和补齐的路径之后
+void corrupt(const std::string& file, uint8_t tag, int n, const std::function<uint64_t(uint64_t)>& change)
+{
+    std::string data;
+    {
+        std::ifstream in(file, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    uint32_t path_size;
+    uint64_t word_count;
+    std::memcpy(&path_size, data.data() + 12, sizeof(path_size));
+    std::memcpy(&word_count, data.data() + 32, sizeof(word_count));
+    std::size_t words_at = 64 + ((path_size + 7) & ~std::size_t(7));
+    for (std::size_t i = 0; i < word_count; i++) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + words_at + i * 8, sizeof(word));
+        if ((word >> 56) == tag && n-- == 0) {
+            word = change(word);
+            std::memcpy(&data[words_at + i * 8], &word, sizeof(word));
+            break;
+        }
+    }
+    std::ofstream out(file, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), data.size());
+}
+
+}  // namespace
+
+int main()
+{
+    fs::path dir = fs::temp_directory_path() / fmt::format("json_test_cache_{}", ::getpid());
+    fs::create_directories(dir);
+    std::string source = (dir / "source.json").string();
+    {
+        std::ofstream out(source);
+        out << R"({"name":"cache","list":[1,2.5,{"x":-7}],"ok":true})";
+    }
+    json_tape_cache cache((dir / "cache").string());
+    std::string     file = cache.cache_path(source);
+
+    check_values(cache.load(source), "first load parses");
+    json_cached_tape hit = cache.load(source);
+    check(hit.from_cache(), "second load maps the cache");
+    check_values(hit, "values from the cache");
+
+    //* 字符串偏移指到字符串区之外
+    corrupt(file, '"', 0, [](uint64_t w) { return w | 0xFFFFFFFFFFULL; });
+    json_cached_tape bad_string = cache.load(source);
+    check(!bad_string.from_cache(), "string offset out of range is rejected");
+    check_values(bad_string, "values after a bad string offset");
+
+    //* 数组的闭合下标指到 tape 之外
+    corrupt(file, '[', 0, [](uint64_t w) { return w | 0xFFFFFFFFULL; });
+    json_cached_tape bad_jump = cache.load(source);
+    check(!bad_jump.from_cache(), "jump index out of range is rejected");
+    check_values(bad_jump, "values after a bad jump index");
+
+    //* 对象的成员数与实际不符
+    corrupt(file, '{', 1, [](uint64_t w) { return w + (uint64_t(1) << 32); });
+    check(!cache.load(source).from_cache(), "wrong member count is rejected");
+
+    //* 未知的标签
+    corrupt(file, 't', 0, [](uint64_t w) { return (w & ((uint64_t(1) << 56) - 1)) | (uint64_t('?') << 56); });
+    check(!cache.load(source).from_cache(), "unknown tag is rejected");
+
+    //* 每次回退都重写了缓存, 之后又能命中
+    check(cache.load(source).from_cache(), "cache is rewritten after a fallback");
+
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    if (failures != 0) {
+        return 1;
+    }
+    fmt::print("test_cache: ok\n");
+    return 0;
+}
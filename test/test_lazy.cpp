@@ -0,0 +1,84 @@
+//* 按需访问: 正常的取值, 以及截断在转义中间的输入必须报错而不是读出输入之外
+//* make test 运行, 有失败的检查就返回非 0
+
+#include "../json_lazy.hpp"
+
+#include <cstring>
+#include <fmt/format.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fmt::print("test_lazy: FAILED {}\n", what);
+        failures++;
+    }
+}
+
+//* f 必须抛出 std::runtime_error
+template <class F> void check_throws(F&& f, const char* what)
+{
+    try {
+        f();
+    } catch (const std::runtime_error&) {
+        return;
+    }
+    check(false, what);
+}
+
+//* 拷贝到大小正好的堆内存里, 越界读在 ASan 下能被发现
+std::unique_ptr<char[]> exact_copy(const std::string& text)
+{
+    std::unique_ptr<char[]> buf(new char[text.size()]);
+    std::memcpy(buf.get(), text.data(), text.size());
+    return buf;
+}
+
+}  // namespace
+
+int main()
+{
+    {
+        std::string        text = R"({"a":"x\"y","b":[1,{"c":true}],"d":null})";
+        json_lazy_document doc(text.data(), text.size());
+        check(doc["a"].get_string() == "x\"y", "escaped string value");
+        check(doc["b"][1]["c"].get_boolean(), "nested access after an escaped string");
+        check(doc["d"].is_null(), "null after skipped containers");
+        check(doc["b"].raw() == R"([1,{"c":true}])", "raw() of an array");
+    }
+    //* 反斜杠是输入的最后一个字节
+    {
+        std::string        text = R"({"a":"x\)";
+        auto               buf  = exact_copy(text);
+        json_lazy_document doc(buf.get(), text.size());
+        check_throws([&] { doc["a"].raw(); }, "raw() of a string ending in a backslash");
+        check_throws([&] { doc["a"].get_string(); }, "get_string() of a string ending in a backslash");
+        check_throws([&] { doc["b"]; }, "key lookup past a string ending in a backslash");
+    }
+    {
+        std::string        text = R"(["x\)";
+        auto               buf  = exact_copy(text);
+        json_lazy_document doc(buf.get(), text.size());
+        check_throws([&] { doc[0].raw(); }, "raw() of an element ending in a backslash");
+        check_throws([&] { doc[1]; }, "index lookup past a string ending in a backslash");
+    }
+    {
+        std::string        text = R"({"a\)";
+        auto               buf  = exact_copy(text);
+        json_lazy_document doc(buf.get(), text.size());
+        check_throws([&] { doc["a"]; }, "key ending in a backslash");
+        check_throws([&] { doc.root().raw(); }, "raw() of an object truncated in a key");
+    }
+    if (failures == 0) {
+        fmt::print("test_lazy: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+//* 编译期配置的解析器: 只用 double 的数字与精确解析再转换的结果相同; 不解码的字符串截断在转义中间时必须报错
+//* make test 运行, 有失败的检查就返回非 0
+
+#include "../json_basic_parser.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <fmt/format.h>
+#include <memory>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fmt::print("test_policy: FAILED {}\n", what);
+        failures++;
+    }
+}
+
+//* 拷贝到大小正好的堆内存里, 越界读在 ASan 下能被发现
+std::unique_ptr<char[]> exact_copy(const std::string& text)
+{
+    std::unique_ptr<char[]> buf(new char[text.size()]);
+    std::memcpy(buf.get(), text.data(), text.size());
+    return buf;
+}
+
+//* 用 json_minimal_policy 解析 text, 期望在 offset 处报 message
+void check_error(const std::string& text, std::size_t offset, const char* message, const char* what)
+{
+    auto                                   buf = exact_copy(text);
+    json_basic_parser<json_minimal_policy> parser(buf.get(), text.size());
+    json_document                          doc;
+    json_parse_result                      result = parser.parse(doc);
+    check(result.status == PARSE_ERROR && result.offset == offset && result.message == message, what);
+}
+
+}  // namespace
+
+int main()
+{
+    {
+        std::string                            text = R"({"a":"x\"y","b":[1,2.5]})";
+        json_basic_parser<json_minimal_policy> parser(text.data(), text.size());
+        json_document                          doc;
+        check(parser.parse(doc).ok(), "valid input");
+        check(doc["a"].get_string() == R"(x\"y)", "raw string keeps the escape");
+    }
+    //* 整数直接解析成 double, 结果与精确解析之后再转换的相同
+    {
+        const char* numbers[] = {"0", "-0", "42", "-17", "9007199254740993", "18446744073709551615", "123456789012345678901234567890",
+                                 "-9223372036854775809", "1.5", "2.5e-3", "1e308"};
+        for (const char* number : numbers) {
+            std::string                            text = fmt::format("[{}]", number);
+            json_basic_parser<json_minimal_policy> parser(text.data(), text.size());
+            json_document                          doc;
+            json_number                            exact;
+            parse_number(number, number + std::strlen(number), exact);
+            check(parser.parse(doc).ok() && !doc[0].is_integer() && doc[0].get_number() == exact.as_double() &&
+                      std::signbit(doc[0].get_number()) == std::signbit(exact.as_double()),
+                  "double-only number matches the exact parse");
+        }
+    }
+    //* 反斜杠是输入的最后一个字节
+    check_error(R"("abc\)", 0, "Unterminated string", "top-level string ending in a backslash");
+    check_error(R"(["abc\)", 1, "Unterminated string", "element ending in a backslash");
+    check_error(R"({"a\)", 1, "Unterminated string", "key ending in a backslash");
+    if (failures == 0) {
+        fmt::print("test_policy: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+//* 复用解析器和文档: 预热一次之后, 同样形状的消息 reset + parse(json_document&) 不再调用 operator new
+//* make test 运行, 有任何一次分配就返回非 0
+
+#include "../json_parser.hpp"
+
+#include <cstdlib>
+#include <fmt/format.h>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace json;
+
+namespace {
+
+std::size_t allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+int main()
+{
+    //* 值不同、结构和长度相同的消息, 其中带转义的字符串要经过解码缓冲区
+    std::vector<std::string> messages;
+    for (int i = 0; i < 1000; i++) {
+        messages.push_back(fmt::format(R"({{"jsonrpc":"2.0","id":{},"method":"user.update","params":{{"name":"user_{:04}\n",)"
+                                       R"("score":{}.5,"tags":["a","b",{{"k":null}}],"active":{}}}}})",
+                                       100000 + i, i % 10000, i % 10, i % 2 ? "true" : "false"));
+    }
+
+    json_parser   parser;
+    json_document doc;
+    parser.reset(messages[0].data(), messages[0].size());
+    parser.parse(doc);
+
+    std::size_t before = allocations;
+    int64_t     sum    = 0;
+    for (const std::string& m : messages) {
+        parser.reset(m.data(), m.size());
+        parser.parse(doc);
+        sum += doc["id"].get_int64();
+    }
+    std::size_t count = allocations - before;
+    if (count != 0 || sum != 100000 * 1000 + 999 * 1000 / 2) {
+        fmt::print("test_reuse: FAILED, {} allocations in {} messages (sum {})\n", count, messages.size(), sum);
+        return 1;
+    }
+    fmt::print("test_reuse: ok, 0 allocations in {} messages\n", messages.size());
+    return 0;
+}
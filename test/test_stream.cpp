@@ -0,0 +1,59 @@
+//* 增量解析: 嵌套深度限制, 以及错误位置从送入的第一个字节算起
+//* make test 运行, 有失败的检查就返回非 0
+
+#include "../json_stream.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <string>
+
+using namespace json;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fmt::print("test_stream: FAILED {}\n", what);
+        failures++;
+    }
+}
+
+//* 按 step 字节一段送入 text, 返回错误的位置, 没有错误时返回 npos
+std::size_t error_offset(const std::string& text, std::size_t step, std::size_t max_depth = json_grammar::default_max_depth)
+{
+    json_document         doc;
+    json_document_builder builder(doc);
+    json_stream_parser    stream(builder);
+    stream.set_max_depth(max_depth);
+    try {
+        for (std::size_t i = 0; i < text.size(); i += step) {
+            stream.feed(text.data() + i, std::min(step, text.size() - i));
+        }
+        stream.finish();
+    } catch (const json_parse_error& e) {
+        return e.offset();
+    }
+    return json_parse_error::npos;
+}
+
+}  // namespace
+
+int main()
+{
+    std::string deep = std::string(10, '[') + std::string(10, ']');
+    check(error_offset(deep, 3, 10) == json_parse_error::npos, "depth at the limit");
+    check(error_offset(deep, 3, 9) == 9, "depth over the limit fails at the bracket");
+
+    std::string bad = R"({"a": [1, 2,, 3], "b": "x"})";
+    for (std::size_t step : {1, 2, 5, 100}) {
+        check(error_offset(bad, step) == 12, "offset counts bytes of earlier chunks");
+    }
+    check(error_offset(R"({"a": "abc)", 4) == 6, "unterminated string at finish");
+    if (failures == 0) {
+        fmt::print("test_stream: ok\n");
+    }
+    return failures == 0 ? 0 : 1;
+}